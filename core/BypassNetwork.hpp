@@ -0,0 +1,155 @@
+// <BypassNetwork.hpp> -*- C++ -*-
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "sparta/simulation/Clock.hpp"
+#include "sparta/utils/SpartaAssert.hpp"
+
+#include "CoreTypes.hpp"
+#include "Inst.hpp"
+
+namespace olympia
+{
+    /**
+     * @file   BypassNetwork.hpp
+     * @brief Forwarding paths between the outputs and inputs of the execute pipes
+     *
+     * Each path forwards a producer pipe's result to a consumer pipe a
+     * number of cycles (the stage) after the result is produced. A
+     * consumer with no path from the producer reads the result from the
+     * register file, register_file_latency cycles after it is produced.
+     * A forwarded result stays on the bypass network forward_window
+     * cycles past its stage, after that it is read from the register
+     * file. With no paths every pipe forwards to every pipe at stage 0.
+     *
+     * Results are tracked per physical register. Registers last written
+     * by a unit outside the execute pipes (the LSU) are available as
+     * soon as the scoreboard says so and are never forwarded.
+     */
+    class BypassNetwork
+    {
+    public:
+        using PathTopology = std::vector<std::vector<std::string>>;
+
+        /**
+         * @param pipe_names   Execute pipe names, indexed by pipe number
+         * @param paths        [["<producer>", "<stage>", "<consumer>", ...], ...]
+         * @param register_file_latency Cycles from a result to its register file read
+         * @param forward_window Cycles a result stays on the bypass network
+         */
+        BypassNetwork(const std::vector<std::string> & pipe_names, const PathTopology & paths,
+                      const uint32_t register_file_latency, const uint32_t forward_window) :
+            num_pipes_(pipe_names.size()),
+            partial_(!paths.empty()),
+            register_file_latency_(register_file_latency),
+            forward_window_(forward_window),
+            stages_(num_pipes_ * num_pipes_, partial_ ? NO_PATH : 0)
+        {
+            auto pipe_number = [&pipe_names](const std::string & name)
+            {
+                const auto itr = std::find(pipe_names.begin(), pipe_names.end(), name);
+                sparta_assert(itr != pipe_names.end(), "Bypass network has unknown pipe " << name);
+                return static_cast<uint32_t>(itr - pipe_names.begin());
+            };
+            for (const auto & path : paths)
+            {
+                sparta_assert(path.size() >= 3, "Bypass network path needs a producer, a stage "
+                                                "and at least one consumer");
+                const uint32_t producer = pipe_number(path[0]);
+                const uint32_t stage = std::stoul(path[1]);
+                for (auto consumer = path.begin() + 2; consumer != path.end(); ++consumer)
+                {
+                    stages_[producer * num_pipes_ + pipe_number(*consumer)] = stage;
+                }
+            }
+            for (auto & results : results_)
+            {
+                results.assign(core_types::RegisterBitMask().size(), Result());
+            }
+        }
+
+        //! True if some pipes do not forward to each other
+        bool isPartial() const { return partial_; }
+
+        //! Record the result of producer_pipe written to dest_bits
+        void recordResult(const core_types::RegFile rf,
+                          const core_types::RegisterBitMask & dest_bits,
+                          const uint32_t producer_pipe, const sparta::Clock::Cycle cycle)
+        {
+            for (uint32_t reg = 0; reg < dest_bits.size(); ++reg)
+            {
+                if (dest_bits.test(reg))
+                {
+                    results_[rf][reg] = {cycle, producer_pipe};
+                }
+            }
+        }
+
+        //! Every source of inst reaches consumer_pipe this cycle, by a
+        //! forwarding path or the register file
+        bool isAvailable(const InstPtr & inst, const uint32_t consumer_pipe,
+                         const sparta::Clock::Cycle cycle) const
+        {
+            for (const auto & src : inst->getRenameData().getSourceList())
+            {
+                if ((src.rf == core_types::RF_INVALID) || src.is_x0)
+                {
+                    continue;
+                }
+                const Result & result = results_[src.rf][src.val];
+                if ((result.producer_pipe == NO_PIPE)
+                    || (cycle >= result.cycle + register_file_latency_))
+                {
+                    continue;
+                }
+                const uint32_t stage = stages_[result.producer_pipe * num_pipes_ + consumer_pipe];
+                if ((stage == NO_PATH) || (cycle < result.cycle + stage))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        //! The source is taken from the bypass network, not a register
+        //! file read port
+        bool isForwarded(const Inst::RenameData::Reg & src, const uint32_t consumer_pipe,
+                         const sparta::Clock::Cycle cycle) const
+        {
+            const Result & result = results_[src.rf][src.val];
+            if (result.producer_pipe == NO_PIPE)
+            {
+                return false;
+            }
+            const uint32_t stage = stages_[result.producer_pipe * num_pipes_ + consumer_pipe];
+            return (stage != NO_PATH) && (cycle >= result.cycle + stage)
+                   && (cycle - result.cycle - stage <= forward_window_);
+        }
+
+    private:
+        static constexpr uint32_t NO_PATH = std::numeric_limits<uint32_t>::max();
+        static constexpr uint32_t NO_PIPE = std::numeric_limits<uint32_t>::max();
+
+        struct Result
+        {
+            sparta::Clock::Cycle cycle = 0;
+            uint32_t producer_pipe = NO_PIPE;
+        };
+
+        const uint32_t num_pipes_;
+        const bool partial_;
+        const uint32_t register_file_latency_;
+        const uint32_t forward_window_;
+        // Forwarding stage of each producer, consumer pipe pair
+        std::vector<uint32_t> stages_;
+        // Last result written to each physical register
+        std::array<std::vector<Result>, core_types::N_REGFILES> results_;
+    };
+}
@@ -268,6 +268,14 @@ olympia::CoreTopologySimple::CoreTopologySimple(){
             "cpu.core*.rob.ports.out_rob_retire_ack_rename",
             "cpu.core*.rename.ports.in_rename_retire_ack"
         },
+        {
+            "cpu.core*.rob.ports.out_rob_retire_ack_rename",
+            "cpu.core*.fetch.ports.in_rob_retire_ack"
+        },
+        {
+            "cpu.core*.rob.ports.out_rob_critical_load",
+            "cpu.core*.dispatch.ports.in_rob_critical_load"
+        },
         {
             "cpu.core*.flushmanager.ports.out_flush_upper",
             "cpu.core*.dispatch.ports.in_reorder_flush"
@@ -343,6 +351,11 @@ void olympia::CoreTopologySimple::bindTree(sparta::RootTreeNode* root_node)
             ;
             const std::string flush_manager = flushmanager_ports + ".out_flush_upper";
             bind_ports(exe_flush_in, flush_manager);
+
+            // Branches resolved at execute request a flush
+            const std::string exe_flush_out =
+                core_node + ".execute." + unit_name + ".ports.out_execute_flush";
+            bind_ports(exe_flush_out, flushmanager_ports + ".in_flush_request");
         }
 
         const auto issue_queue_to_pipe_map = olympia::coreutils::getPipeTopology(
@@ -402,6 +415,11 @@ void olympia::CoreTopologySimple::bindTree(sparta::RootTreeNode* root_node)
             ;
             const std::string flush_manager = flushmanager_ports + ".out_flush_upper";
             bind_ports(exe_flush_in, flush_manager);
+
+            // Speculative wakeups of load dependents
+            const std::string iq_load_wakeup_in =
+                core_node + ".execute." + unit_name + ".ports.in_load_wakeup";
+            bind_ports(iq_load_wakeup_in, core_node + ".lsu.ports.out_load_wakeup");
         }
     }
 }
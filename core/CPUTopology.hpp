@@ -153,6 +153,11 @@ namespace olympia
         using IssueQueueTopology = std::vector<std::vector<std::string>>;
         using IssueQueueTopologyParam = sparta::Parameter<IssueQueueTopology>;
 
+        using ClusterTopology = std::vector<std::vector<std::string>>;
+        using ClusterTopologyParam = sparta::Parameter<ClusterTopology>;
+        using LatencyParam = sparta::Parameter<uint32_t>;
+        using CountParam = sparta::Parameter<uint32_t>;
+
         CoreExtensions() : sparta::ExtensionsParamsOnly() {}
 
         virtual ~CoreExtensions() {}
@@ -191,6 +196,53 @@ namespace olympia
                                                                  "Rename for IssueQueues"
                                                                  "Defines alias for IssueQueue",
                                                                  ps));
+
+            //
+            // Example of a 2 cluster backend, each issue queue brings
+            // its execution pipes into the cluster:
+            //  [["lsu", "iq0", "iq1"], ["iq2", "iq3"]]
+            //
+            //  When set, the rename scoreboard latency matrices are
+            //  derived from the clusters
+            //
+            clusters_.reset(new ClusterTopologyParam(
+                "clusters", ClusterTopology(),
+                "Backend clusters, the lsu and issue queues sharing a bypass network. "
+                "Expect: [[\"<unit_name>\", ...]] ",
+                ps));
+            intra_cluster_latency_.reset(
+                new LatencyParam("intra_cluster_latency", 1,
+                                 "Forwarding latency between units of the same cluster", ps));
+            inter_cluster_latency_.reset(
+                new LatencyParam("inter_cluster_latency", 2,
+                                 "Forwarding latency between units of different clusters", ps));
+
+            //
+            // Example of a bypass network, each path is a producer
+            // pipe, the cycles after its result the path forwards
+            // (the stage) and the consumer pipes:
+            //  [["exe0", "0", "exe0", "exe1"], ["exe1", "1", "exe0"]]
+            //
+            //  Consumers with no path from the producer read the
+            //  result from the register file.  Empty forwards every
+            //  pipe to every pipe at stage 0
+            //
+            bypass_network_.reset(new PipeTopologyParam(
+                "bypass_network", PipeTopology(),
+                "Forwarding paths between the execution pipes. "
+                "Expect: [[\"<producer>\", \"<stage>\", \"<consumer>\", ...]] ",
+                ps));
+            register_file_latency_.reset(new LatencyParam(
+                "register_file_latency", 2,
+                "Cycles from a result to its register file read, for consumers not on a "
+                "forwarding path",
+                ps));
+
+            num_threads_.reset(new CountParam("num_threads", 1,
+                                              "Hardware threads (SMT) per core. Each thread has "
+                                              "its own workload, rename map and ROB order, the "
+                                              "rest of the core is shared",
+                                              ps));
         }
 
       private:
@@ -199,6 +251,12 @@ namespace olympia
         std::unique_ptr<IssueQueueTopologyParam> issue_queue_to_pipe_map_;
         std::unique_ptr<PipeTopologyParam> exe_pipe_rename_;
         std::unique_ptr<PipeTopologyParam> issue_queue_rename_;
+        std::unique_ptr<ClusterTopologyParam> clusters_;
+        std::unique_ptr<LatencyParam> intra_cluster_latency_;
+        std::unique_ptr<LatencyParam> inter_cluster_latency_;
+        std::unique_ptr<PipeTopologyParam> bypass_network_;
+        std::unique_ptr<LatencyParam> register_file_latency_;
+        std::unique_ptr<CountParam> num_threads_;
     };
 
     /**
@@ -2,6 +2,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <map>
+#include <string>
 #include <vector>
 #include "sparta/simulation/TreeNode.hpp"
 #include "sparta/utils/Utils.hpp"
@@ -19,6 +22,166 @@ namespace olympia::coreutils
             ->getValueAs<olympia::CoreExtensions::PipeTopology>();
     }
 
+    inline uint32_t getCoreValue(sparta::TreeNode* node, const std::string & value_name)
+    {
+        auto core_extension = node->getExtension(olympia::CoreExtensions::name);
+        auto core_extension_params = sparta::notNull(core_extension)->getParameters();
+        auto value_param = sparta::notNull(core_extension_params)->getParameter(value_name);
+        return sparta::notNull(value_param)->getValueAs<uint32_t>();
+    }
+
+    //! Number of hardware threads (SMT) of the core
+    inline uint32_t getNumThreads(sparta::TreeNode* node)
+    {
+        return getCoreValue(node, "num_threads");
+    }
+
+    //! Execute pipe names, after exe_pipe_rename, indexed by pipe number
+    inline std::vector<std::string> getExePipeNames(sparta::TreeNode* node)
+    {
+        const auto exe_pipe_rename = getPipeTopology(node, "exe_pipe_rename");
+        const auto num_pipes = getPipeTopology(node, "pipelines").size();
+        std::vector<std::string> names;
+        for (size_t pipe_idx = 0; pipe_idx < num_pipes; ++pipe_idx)
+        {
+            names.emplace_back(exe_pipe_rename.empty() ? "exe" + std::to_string(pipe_idx)
+                                                       : exe_pipe_rename[pipe_idx][1]);
+        }
+        return names;
+    }
+
+    /**
+     * \brief Forwarding latency matrix derived from the core's clusters
+     *
+     * The matrix has the layout of the rename scoreboard latency_matrix
+     * parameter, labelled by the lsu and the issue queue names. Units in
+     * the same cluster forward with intra_cluster_latency, units in
+     * different clusters with inter_cluster_latency. Returns an empty
+     * matrix when no clusters are defined.
+     */
+    inline auto getClusterLatencyMatrix(sparta::TreeNode* node)
+    {
+        const auto clusters = getPipeTopology(node, "clusters");
+        olympia::CoreExtensions::ClusterTopology matrix;
+        if (clusters.empty())
+        {
+            return matrix;
+        }
+
+        // Every issue queue and the lsu belongs to exactly one cluster
+        std::vector<std::string> units{"lsu"};
+        const auto issue_queue_rename = getPipeTopology(node, "issue_queue_rename");
+        const auto num_iqs = getPipeTopology(node, "issue_queue_to_pipe_map").size();
+        for (size_t iq_num = 0; iq_num < num_iqs; ++iq_num)
+        {
+            units.emplace_back(issue_queue_rename.empty() ? "iq" + std::to_string(iq_num)
+                                                          : issue_queue_rename[iq_num][1]);
+        }
+        std::map<std::string, size_t> unit_cluster;
+        for (size_t cluster = 0; cluster < clusters.size(); ++cluster)
+        {
+            for (const auto & unit : clusters[cluster])
+            {
+                sparta_assert(std::find(units.begin(), units.end(), unit) != units.end(),
+                              "Cluster " << cluster << " has unknown unit " << unit);
+                sparta_assert(unit_cluster.emplace(unit, cluster).second,
+                              "Unit " << unit << " is in more than one cluster");
+            }
+        }
+        for (const auto & unit : units)
+        {
+            sparta_assert(unit_cluster.count(unit) != 0, "Unit " << unit << " is in no cluster");
+        }
+
+        const auto intra_latency = std::to_string(getCoreValue(node, "intra_cluster_latency"));
+        const auto inter_latency = std::to_string(getCoreValue(node, "inter_cluster_latency"));
+        matrix.emplace_back(1, "");
+        matrix.front().insert(matrix.front().end(), units.begin(), units.end());
+        for (const auto & producer : units)
+        {
+            auto & row = matrix.emplace_back(1, producer);
+            for (const auto & consumer : units)
+            {
+                row.emplace_back((unit_cluster[producer] == unit_cluster[consumer]) ? intra_latency
+                                                                                    : inter_latency);
+            }
+        }
+        return matrix;
+    }
+
+    /**
+     * \brief Merge a scoreboard latency_matrix with the cluster derived one
+     *
+     * Each entry takes the higher of the two latencies, a latency set in
+     * the matrix above the cluster latency is kept. Units the matrix
+     * does not list take the cluster latency. num_raised counts the
+     * entries of the matrix raised to the cluster latency.
+     */
+    inline auto mergeClusterLatencyMatrix(const olympia::CoreExtensions::ClusterTopology & matrix,
+                                          const olympia::CoreExtensions::ClusterTopology & cluster_matrix,
+                                          uint32_t & num_raised)
+    {
+        std::map<std::pair<std::string, std::string>, uint32_t> latencies;
+        if (!matrix.empty())
+        {
+            const auto & consumers = matrix.front();
+            for (size_t row = 1; row < matrix.size(); ++row)
+            {
+                for (size_t col = 1; col < std::min(matrix[row].size(), consumers.size()); ++col)
+                {
+                    latencies[{matrix[row][0], consumers[col]}] = std::stoul(matrix[row][col]);
+                }
+            }
+        }
+
+        num_raised = 0;
+        auto merged = cluster_matrix;
+        const auto & consumers = merged.front();
+        for (size_t row = 1; row < merged.size(); ++row)
+        {
+            for (size_t col = 1; col < merged[row].size(); ++col)
+            {
+                const auto match = latencies.find({merged[row][0], consumers[col]});
+                if (match == latencies.end())
+                {
+                    continue;
+                }
+                const uint32_t cluster_latency = std::stoul(merged[row][col]);
+                if (match->second >= cluster_latency)
+                {
+                    merged[row][col] = std::to_string(match->second);
+                }
+                else
+                {
+                    ++num_raised;
+                }
+            }
+        }
+        return merged;
+    }
+
+    //! True if every latency of a latency_matrix is the same, such a
+    //! matrix models no forwarding topology
+    inline bool isUniformLatencyMatrix(const olympia::CoreExtensions::ClusterTopology & matrix)
+    {
+        std::string latency;
+        for (size_t row = 1; row < matrix.size(); ++row)
+        {
+            for (size_t col = 1; col < matrix[row].size(); ++col)
+            {
+                if (latency.empty())
+                {
+                    latency = matrix[row][col];
+                }
+                else if (matrix[row][col] != latency)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
     inline core_types::RegFile determineRegisterFile(const mavis::OperandInfo::Element & reg)
     {
         static const std::map<mavis::InstMetaData::OperandTypes, core_types::RegFile>
@@ -28,7 +191,8 @@ namespace olympia::coreutils
                 {mavis::InstMetaData::OperandTypes::DOUBLE, core_types::RegFile::RF_FLOAT},
                 {mavis::InstMetaData::OperandTypes::WORD, core_types::RegFile::RF_INTEGER},
                 {mavis::InstMetaData::OperandTypes::LONG, core_types::RegFile::RF_INTEGER},
-                {mavis::InstMetaData::OperandTypes::QUAD, core_types::RegFile::RF_INTEGER}};
+                {mavis::InstMetaData::OperandTypes::QUAD, core_types::RegFile::RF_INTEGER},
+                {mavis::InstMetaData::OperandTypes::VECTOR, core_types::RegFile::RF_VECTOR}};
         if (auto match = mavis_optype_to_regfile.find(reg.operand_type);
             match != mavis_optype_to_regfile.end())
         {
@@ -48,6 +212,10 @@ namespace olympia::coreutils
         {
             return core_types::RF_FLOAT;
         }
+        else if (target_name == "vec")
+        {
+            return core_types::RF_VECTOR;
+        }
         sparta_assert(false, "Not supported this target: " << target_name);
         return core_types::RF_INVALID;
     }
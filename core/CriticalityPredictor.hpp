@@ -0,0 +1,76 @@
+// <CriticalityPredictor.hpp> -*- C++ -*-
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "sparta/utils/SpartaAssert.hpp"
+
+namespace olympia
+{
+    /**
+     * @file   CriticalityPredictor.hpp
+     * @brief PC indexed table of saturating counters predicting critical instructions
+     *
+     * An instruction is trained each time it is seen on the critical
+     * path: a load at the head of the ROB while retirement stalls, or a
+     * producer of a mispredicted branch. It is predicted critical while
+     * its counter is at or above the threshold. Every table size
+     * trainings all counters are halved, so instructions that stop
+     * being critical age out. A table size of 0 disables the predictor.
+     */
+    class CriticalityPredictor
+    {
+    public:
+        CriticalityPredictor(const uint32_t table_size, const uint32_t threshold,
+                             const uint32_t counter_max) :
+            threshold_(threshold),
+            counter_max_(counter_max),
+            counters_(table_size, 0)
+        {
+            sparta_assert((table_size & (table_size - 1)) == 0,
+                          "criticality_table_size must be a power of 2: " << table_size);
+            sparta_assert((threshold > 0) && (threshold <= counter_max),
+                          "criticality_threshold must be between 1 and the counter maximum "
+                              << counter_max);
+        }
+
+        bool isEnabled() const { return !counters_.empty(); }
+
+        bool isCritical(const uint64_t pc) const
+        {
+            return isEnabled() && (counters_[index_(pc)] >= threshold_);
+        }
+
+        void train(const uint64_t pc)
+        {
+            if (!isEnabled())
+            {
+                return;
+            }
+            uint8_t & counter = counters_[index_(pc)];
+            if (counter < counter_max_)
+            {
+                ++counter;
+            }
+            if (++num_trained_ == counters_.size())
+            {
+                num_trained_ = 0;
+                for (auto & entry : counters_)
+                {
+                    entry >>= 1;
+                }
+            }
+        }
+
+    private:
+        // Instructions are at least 2 byte aligned
+        uint32_t index_(const uint64_t pc) const { return (pc >> 1) & (counters_.size() - 1); }
+
+        const uint32_t threshold_;
+        const uint32_t counter_max_;
+        std::vector<uint8_t> counters_;
+        uint64_t num_trained_ = 0;
+    };
+}
@@ -38,8 +38,7 @@ namespace olympia {
     // Access DCache
     bool DCache::dataLookup_(const MemoryAccessInfoPtr & mem_access_info_ptr)
     {
-        const InstPtr & inst_ptr = mem_access_info_ptr->getInstPtr();
-        uint64_t phyAddr = inst_ptr->getRAdr();
+        uint64_t phyAddr = mem_access_info_ptr->getPhyAddr();
 
         bool cache_hit = false;
 
@@ -1,6 +1,7 @@
 // <Decode.cpp> -*- C++ -*-
 
 #include "Decode.hpp"
+#include "OlympiaAllocators.hpp"
 #include "fusion/FusionTypes.hpp"
 
 #include "sparta/events/StartupEvent.hpp"
@@ -15,6 +16,11 @@ namespace olympia
 {
     constexpr char Decode::name[];
 
+    const std::map<std::string, uint32_t> Decode::decode_class_map_ = {
+        {"int", DECODE_CLASS_INT},         {"mem", DECODE_CLASS_MEM},
+        {"float", DECODE_CLASS_FLOAT},     {"branch", DECODE_CLASS_BRANCH},
+        {"complex", DECODE_CLASS_COMPLEX}, {"all", DECODE_CLASS_ALL}};
+
     Decode::Decode(sparta::TreeNode* node, const DecodeParameterSet* p) :
         sparta::Unit(node),
 
@@ -40,11 +46,54 @@ namespace olympia
                                   "Optimistic prediction of the cycles saved by fusion",
                                   sparta::Counter::COUNT_NORMAL),
 
+        fusion_num_window_fusions_(&unit_stat_set_, "fusion_num_window_fusions",
+                                   "Fusions formed with instructions held in the fusion window",
+                                   sparta::Counter::COUNT_NORMAL),
+
+        fusion_window_stall_cycles_(&unit_stat_set_, "fusion_window_stall_cycles",
+                                    "Cycles decode waited on the fusion window",
+                                    sparta::Counter::COUNT_NORMAL),
+
+        num_cracked_insts_(&unit_stat_set_, "num_cracked_insts",
+                           "The number of instructions cracked into micro-ops",
+                           sparta::Counter::COUNT_NORMAL),
+
+        num_cracked_uops_(&unit_stat_set_, "num_cracked_uops",
+                          "The number of micro-ops created by cracking",
+                          sparta::Counter::COUNT_NORMAL),
+
+        decode_stall_no_insts_(&unit_stat_set_, "decode_stall_no_insts",
+                               "Decode groups cut short by an empty fetch queue",
+                               sparta::Counter::COUNT_NORMAL),
+
+        decode_stall_no_credits_(&unit_stat_set_, "decode_stall_no_credits",
+                                 "Decode groups cut short by uop queue credits",
+                                 sparta::Counter::COUNT_NORMAL),
+
+        decode_stall_slot_class_(&unit_stat_set_, "decode_stall_slot_class",
+                                 "Decode groups cut short by decode slot capabilities",
+                                 sparta::Counter::COUNT_NORMAL),
+
+        decode_stall_branch_limit_(&unit_stat_set_, "decode_stall_branch_limit",
+                                   "Decode groups cut short by the branch limit",
+                                   sparta::Counter::COUNT_NORMAL),
+
+        decode_stall_thread_switch_(&unit_stat_set_, "decode_stall_thread_switch",
+                                    "Decode groups cut short by an instruction of another thread",
+                                    sparta::Counter::COUNT_NORMAL),
+
         num_to_decode_(p->num_to_decode),
+        decode_slot_masks_(parseDecodeSlots_(p->decode_slot_classes, p->num_to_decode)),
+        max_branches_per_cycle_(p->max_branches_per_cycle),
+        enable_uop_cracking_(p->enable_uop_cracking),
+        rename_csr_reads_(p->rename_csr_reads),
+        inst_allocator_(
+            sparta::notNull(OlympiaAllocators::getOlympiaAllocators(node))->inst_allocator),
         fusion_enable_(p->fusion_enable),
         fusion_debug_(p->fusion_debug),
         fusion_enable_register_(p->fusion_enable_register),
         fusion_max_latency_(p->fusion_max_latency),
+        fusion_use_static_tables_(p->fusion_use_static_tables),
         fusion_match_max_tries_(p->fusion_match_max_tries),
         fusion_max_group_size_(p->fusion_max_group_size),
         fusion_summary_report_(p->fusion_summary_report),
@@ -73,9 +122,32 @@ namespace olympia
     {
         if (fusion_enable_)
         {
-            fuser_  = std::make_unique<FusionType>(fusion_group_definitions_);
+            if (fusion_use_static_tables_)
+            {
+                FusionGroupCfgListType cfgs;
+                fusion_use_static_tables_ = constructStaticFusionGroups_(cfgs);
+                if (fusion_use_static_tables_)
+                {
+                    fuser_ = std::make_unique<FusionType>(cfgs);
+                }
+            }
+            if (!fusion_use_static_tables_)
+            {
+                fuser_ = std::make_unique<FusionType>(fusion_group_definitions_);
+            }
             hcache_ = fusion::HCache(FusionGroupType::jenkins_1aat);
             fusion_num_groups_defined_ = fuser_->getFusionGroupContainer().size();
+
+            // Collect the leading sub-sequences of every group, these
+            // are the candidates held back by the fusion window
+            for (auto & fgPair : fuser_->getFusionGroupContainer())
+            {
+                const InstUidListType & uids = fgPair.second.uids();
+                for (size_t len = 1; len < uids.size(); ++len)
+                {
+                    fusion_group_prefixes_.emplace(uids.begin(), uids.begin() + len);
+                }
+            }
         }
         else
         {
@@ -116,8 +188,25 @@ namespace olympia
     void Decode::handleFlush_(const FlushManager::FlushingCriteria & criteria)
     {
         ILOG("Got a flush call for " << criteria);
-        fetch_queue_credits_outp_.send(fetch_queue_.size());
+
+        // Keep the instructions of the other hardware threads
+        std::vector<InstPtr> surviving;
+        for (const auto & inst : fetch_queue_)
+        {
+            if (!criteria.includedInFlush(inst))
+            {
+                surviving.emplace_back(inst);
+            }
+        }
+        fetch_queue_credits_outp_.send(fetch_queue_.size() - surviving.size());
         fetch_queue_.clear();
+        for (const auto & inst : surviving)
+        {
+            fetch_queue_.push(inst);
+        }
+        latency_count_ = 0;
+        num_held_insts_ = 0;
+        held_uid_ = 0;
     }
 
     // Decode instructions
@@ -126,18 +215,75 @@ namespace olympia
         uint32_t num_decode = std::min(uop_queue_credits_, fetch_queue_.size());
         num_decode = std::min(num_decode, num_to_decode_);
 
-        // buffer to maximize the chances of a group match limited
-        // by max allowed latency, bounded by max group size
-        if (fusion_enable_)
+        // A decode group holds instructions of one hardware thread, fusion
+        // never crosses threads
+        bool thread_switch = false;
+        for (uint32_t i = 1; i < num_decode; ++i)
         {
-            if (num_decode < fusion_max_group_size_ && latency_count_ < fusion_max_latency_)
+            if (fetch_queue_.read(i)->getThreadID() != fetch_queue_.read(0)->getThreadID())
+            {
+                num_decode = i;
+                thread_switch = true;
+                break;
+            }
+        }
+
+        // Hold back trailing fusion candidates to maximize the chances
+        // of a group match, limited by max allowed latency
+        uint32_t num_hold = 0;
+        if (fusion_enable_ && (num_decode > 0))
+        {
+            num_hold = fusionWindowHoldCount_(num_decode);
+            if (num_hold > 0)
+            {
+                // fusion_max_latency bounds the hold of each candidate,
+                // a new trailing candidate starts its own count
+                const uint64_t held_uid = fetch_queue_.read(num_decode - num_hold)->getUniqueID();
+                if (held_uid != held_uid_)
+                {
+                    held_uid_ = held_uid;
+                    latency_count_ = 0;
+                }
+            }
+            if (num_hold > 0 && latency_count_ < fusion_max_latency_)
             {
                 ++latency_count_;
-                return;
+                num_decode -= num_hold;
+                if (num_decode == 0)
+                {
+                    ++fusion_window_stall_cycles_;
+                    ILOG("Fusion window holding " << num_hold << " insts, cycle "
+                         << latency_count_);
+                    num_held_insts_ = num_hold;
+                    ev_decode_insts_event_.schedule(1);
+                    return;
+                }
+            }
+            else
+            {
+                // Hold released. A candidate that used up its latency
+                // keeps its count so it is not held again.
+                if (num_hold == 0)
+                {
+                    latency_count_ = 0;
+                }
+                num_hold = 0;
+                num_held_insts_ = 0;
             }
         }
 
-        latency_count_ = 0;
+        // Reason the group is smaller than the decode width, if the
+        // slots do not cut it shorter
+        DecodeStall stall = DecodeStall::NONE;
+        if (num_hold == 0 && thread_switch)
+        {
+            stall = DecodeStall::THREAD_SWITCH;
+        }
+        else if (num_hold == 0 && num_decode < num_to_decode_)
+        {
+            stall = (num_decode == fetch_queue_.size()) ? DecodeStall::NO_INSTS
+                                                        : DecodeStall::NO_CREDITS;
+        }
 
         if (num_decode > 0)
         {
@@ -145,10 +291,45 @@ namespace olympia
                 sparta::allocate_sparta_shared_pointer<InstGroup>(instgroup_allocator);
 
             InstUidListType uids;
+            uint32_t num_uops = 0;
+            uint32_t next_slot = 0;
+            uint32_t num_branches = 0;
             // Send instructions on their way to rename
             for (uint32_t i = 0; i < num_decode; ++i)
             {
                 const auto & inst = fetch_queue_.read(0);
+                if (rename_csr_reads_ && inst->isRenameableCsrRead())
+                {
+                    inst->setCsrRenamed();
+                }
+
+                // Place instructions in program order into the slots
+                // that handle their class
+                const uint32_t slot = findDecodeSlot_(inst, next_slot);
+                if (slot >= num_to_decode_)
+                {
+                    stall = DecodeStall::SLOT_CLASS;
+                    break;
+                }
+                if (inst->isBranch() && max_branches_per_cycle_ > 0
+                    && num_branches == max_branches_per_cycle_)
+                {
+                    stall = DecodeStall::BRANCH_LIMIT;
+                    break;
+                }
+
+                // Every micro-op of a cracked instruction needs a credit
+                const uint32_t inst_uops =
+                    enable_uop_cracking_ ? inst->getInstArchInfo()->getNumUops() : 1;
+                if (num_uops + inst_uops > uop_queue_credits_)
+                {
+                    stall = DecodeStall::NO_CREDITS;
+                    break;
+                }
+                num_uops += inst_uops;
+                next_slot = slot + 1;
+                num_branches += inst->isBranch() ? 1 : 0;
+
                 insts->emplace_back(inst);
                 inst->setStatus(Inst::Status::DECODED);
 
@@ -162,14 +343,21 @@ namespace olympia
                 fetch_queue_.pop();
             }
 
-            if (fusion_enable_)
+            if (fusion_enable_ && !insts->empty())
             {
                 MatchInfoListType matches;
                 uint32_t max_itrs = 0;
                 FusionGroupContainerType & container = fuser_->getFusionGroupContainer();
                 do
                 {
-                    matchFusionGroups_(matches, insts, uids, container);
+                    if (fusion_use_static_tables_)
+                    {
+                        matchStaticFusionGroups_(matches, uids);
+                    }
+                    else
+                    {
+                        matchFusionGroups_(matches, insts, uids, container);
+                    }
                     processMatches_(matches, insts, uids);
                     // Future feature whereIsEgon(insts,numGhosts);
                     ++max_itrs;
@@ -179,29 +367,46 @@ namespace olympia
                 {
                     throw sparta::SpartaException("Fusion group match watch dog exceeded.");
                 }
+
+                // The previously held instructions led this group, the
+                // trailing instructions left behind now lead the queue
+                num_held_insts_ = num_hold;
             }
 
-            // Debug statement
-            if (fusion_debug_ && fusion_enable_)
-                infoInsts_(cout, insts);
-            // Send decoded instructions to rename
-            uop_queue_outp_.send(insts);
+            // Fetch queue entries consumed, before cracking
+            const uint32_t num_fetch_credits = insts->size();
 
-            // TODO: whereisegon() would remove the ghosts,
-            // Commented out for now, in practice insts
-            // would be smaller due to the fused ops
-            // uint32_t unfusedInstsSize = insts->size();
+            if (enable_uop_cracking_)
+            {
+                crackInsts_(insts);
+            }
+
+            if (!insts->empty())
+            {
+                // Debug statement
+                if (fusion_debug_ && fusion_enable_)
+                    infoInsts_(cout, insts);
+                // Send decoded instructions to rename
+                uop_queue_outp_.send(insts);
+
+                // TODO: whereisegon() would remove the ghosts,
+                // Commented out for now, in practice insts
+                // would be smaller due to the fused ops
+                // uint32_t unfusedInstsSize = insts->size();
 
-            // Decrement internal Uop Queue credits
-            sparta_assert(uop_queue_credits_ >= insts->size(),
-                 "Attempt to decrement d0q credits below what is available");
+                // Decrement internal Uop Queue credits
+                sparta_assert(uop_queue_credits_ >= insts->size(),
+                     "Attempt to decrement d0q credits below what is available");
 
-            uop_queue_credits_ -= insts->size();
+                uop_queue_credits_ -= insts->size();
 
-            // Send credits back to Fetch to get more instructions
-            fetch_queue_credits_outp_.send(insts->size());
+                // Send credits back to Fetch to get more instructions
+                fetch_queue_credits_outp_.send(num_fetch_credits);
+            }
         }
 
+        countDecodeStall_(stall);
+
         // If we still have credits to send instructions as well as
         // instructions in the queue, schedule another decode session
         if (uop_queue_credits_ > 0 && fetch_queue_.size() > 0)
@@ -209,4 +414,167 @@ namespace olympia
             ev_decode_insts_event_.schedule(1);
         }
     }
+
+    // One class mask per slot from the yaml class names
+    std::vector<uint32_t> Decode::parseDecodeSlots_(const std::vector<std::string> & classes,
+                                                    uint32_t num_to_decode)
+    {
+        if (classes.empty())
+        {
+            return std::vector<uint32_t>(num_to_decode, DECODE_CLASS_ALL);
+        }
+        sparta_assert(classes.size() == num_to_decode,
+                      "decode_slot_classes has " << classes.size()
+                      << " slots, num_to_decode is " << num_to_decode);
+
+        std::vector<uint32_t> masks;
+        for (const auto & slot_classes : classes)
+        {
+            uint32_t mask = 0;
+            size_t pos = 0;
+            while (pos <= slot_classes.size())
+            {
+                const size_t next = std::min(slot_classes.find('|', pos), slot_classes.size());
+                const std::string name = slot_classes.substr(pos, next - pos);
+                const auto itr = decode_class_map_.find(name);
+                sparta_assert(itr != decode_class_map_.end(),
+                              "Unknown decode slot class '" << name << "' in: " << slot_classes);
+                mask |= itr->second;
+                pos = next + 1;
+            }
+            masks.emplace_back(mask);
+        }
+
+        // Every class needs a slot or decode would wait forever
+        uint32_t all_masks = 0;
+        for (const auto mask : masks)
+        {
+            all_masks |= mask;
+        }
+        sparta_assert(all_masks == DECODE_CLASS_ALL,
+                      "Some instruction classes have no decode slot in decode_slot_classes");
+        return masks;
+    }
+
+    uint32_t Decode::getDecodeClass_(const InstPtr & inst) const
+    {
+        if (inst->isBranch())
+        {
+            return DECODE_CLASS_BRANCH;
+        }
+        if (enable_uop_cracking_ && inst->getInstArchInfo()->getNumUops() > 1)
+        {
+            return DECODE_CLASS_COMPLEX;
+        }
+        switch (inst->getPipe())
+        {
+        case InstArchInfo::TargetPipe::SYS:
+        case InstArchInfo::TargetPipe::DIV:
+        case InstArchInfo::TargetPipe::VDIV:
+            return DECODE_CLASS_COMPLEX;
+        case InstArchInfo::TargetPipe::LSU:
+            return DECODE_CLASS_MEM;
+        case InstArchInfo::TargetPipe::FADDSUB:
+        case InstArchInfo::TargetPipe::FLOAT:
+        case InstArchInfo::TargetPipe::FMAC:
+        case InstArchInfo::TargetPipe::F2I:
+        case InstArchInfo::TargetPipe::I2F:
+        case InstArchInfo::TargetPipe::VINT:
+        case InstArchInfo::TargetPipe::VMUL:
+            return DECODE_CLASS_FLOAT;
+        default:
+            return DECODE_CLASS_INT;
+        }
+    }
+
+    uint32_t Decode::findDecodeSlot_(const InstPtr & inst, uint32_t next_slot) const
+    {
+        const uint32_t inst_class = getDecodeClass_(inst);
+        for (uint32_t slot = next_slot; slot < num_to_decode_; ++slot)
+        {
+            if (decode_slot_masks_[slot] & inst_class)
+            {
+                return slot;
+            }
+        }
+        return num_to_decode_;
+    }
+
+    void Decode::countDecodeStall_(DecodeStall reason)
+    {
+        switch (reason)
+        {
+        case DecodeStall::NONE:
+            break;
+        case DecodeStall::NO_INSTS:
+            ++decode_stall_no_insts_;
+            break;
+        case DecodeStall::NO_CREDITS:
+            ++decode_stall_no_credits_;
+            break;
+        case DecodeStall::SLOT_CLASS:
+            ++decode_stall_slot_class_;
+            break;
+        case DecodeStall::BRANCH_LIMIT:
+            ++decode_stall_branch_limit_;
+            break;
+        case DecodeStall::THREAD_SWITCH:
+            ++decode_stall_thread_switch_;
+            break;
+        }
+    }
+
+    // Split cracked instructions into their micro-ops, in order
+    void Decode::crackInsts_(InstGroupPtr & insts)
+    {
+        InstGroupPtr uops = sparta::allocate_sparta_shared_pointer<InstGroup>(instgroup_allocator);
+        for (const auto & inst : *insts)
+        {
+            const auto & uop_infos = inst->getInstArchInfo()->getUops();
+            if (uop_infos.empty())
+            {
+                uops->emplace_back(inst);
+                continue;
+            }
+
+            ++num_cracked_insts_;
+            for (uint32_t idx = 0; idx < uop_infos.size(); ++idx)
+            {
+                InstPtr uop = sparta::allocate_sparta_shared_pointer<Inst>(
+                    inst_allocator_, *inst, uop_infos[idx], idx);
+                ILOG("Cracked: " << inst << " uop " << idx << " pipe: " << uop->getPipe());
+                uops->emplace_back(uop);
+                ++num_cracked_uops_;
+            }
+        }
+        insts = uops;
+    }
+
+    // Determine how many of the last instructions of the next decode
+    // group are the start of a fusion group and should wait for their
+    // partners in the fetch queue
+    uint32_t Decode::fusionWindowHoldCount_(const uint32_t num_decode) const
+    {
+        uint32_t num_hold = 0;
+        if (fusion_max_group_size_ < 2)
+        {
+            return num_hold;
+        }
+
+        InstUidListType tail;
+        const uint32_t max_hold = std::min(num_decode, fusion_max_group_size_ - 1);
+        for (uint32_t len = 1; len <= max_hold; ++len)
+        {
+            tail.clear();
+            for (uint32_t i = num_decode - len; i < num_decode; ++i)
+            {
+                tail.push_back(fetch_queue_.read(i)->getMavisUid());
+            }
+            if (fusion_group_prefixes_.find(tail) != fusion_group_prefixes_.end())
+            {
+                num_hold = len;
+            }
+        }
+        return num_hold;
+    }
 } // namespace olympia
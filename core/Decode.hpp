@@ -22,6 +22,7 @@
 #include <limits>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -75,6 +76,38 @@ namespace olympia
             //! \brief depth of the input instruction buffer
             PARAMETER(uint32_t, fetch_queue_size, 10, "Size of the fetch queue")
 
+            //! \brief instruction classes each decode slot can handle
+            //!
+            //! One entry per decode slot, slot 0 first. An entry is a '|'
+            //! separated list of the classes: int, mem, float, branch,
+            //! complex or all. Complex covers SYS, DIV and cracked
+            //! instructions. Instructions are placed in program order
+            //! into increasing slots. Empty means every slot takes all
+            //! classes, otherwise the list size must equal num_to_decode.
+            PARAMETER(std::vector<std::string>, decode_slot_classes, {},
+                      "Instruction classes accepted by each decode slot")
+
+            //! \brief max branches decoded per cycle, 0 is unlimited
+            PARAMETER(uint32_t, max_branches_per_cycle, 0,
+                      "Max branches decoded per cycle, 0 is unlimited")
+
+            //! \brief crack instructions into micro-ops
+            //!
+            //! Instructions with a "uops" list in the uarch file are
+            //! split into that many micro-ops, each with its own pipe,
+            //! latency and operands. Each micro-op takes a uop queue
+            //! credit and, downstream, its own ROB and issue queue entry.
+            PARAMETER(bool, enable_uop_cracking, false, "Crack instructions into micro-ops")
+
+            //! \brief rename CSR reads instead of serializing on them
+            //!
+            //! Reads of fflags, frm, fcsr and the read-only counters
+            //! (rdcycle, frflags, ...) execute in a pipe with the "csr"
+            //! target and retire without the POST_SYNC flush of other
+            //! SYS instructions. Needs a "csr" pipe in the pipelines.
+            PARAMETER(bool, rename_csr_reads, false,
+                      "Execute CSR reads without side effects in the csr pipe, no flush")
+
             //! \brief enable fusion operations
             //!
             //! master enable, when false fusion_* parmeters have no effect
@@ -97,10 +130,11 @@ namespace olympia
 
             //! \brief max acceptable latency created by gathering uops
             //!
-            //! Depending on the max fusion tuple size uops will be gathered,
-            //! when downstream is not busy this introduces some latency.
-            //! This knob allows studying the effects. fusion_enabled must
-            //! be true
+            //! When the trailing instructions of a decode group are the
+            //! leading part of a fusion group they are held back in the
+            //! fetch queue, for at most this many consecutive cycles, to
+            //! wait for their partners. This knob allows studying the
+            //! effects. fusion_enabled must be true
             PARAMETER(uint32_t, fusion_max_latency, 4, "max fusion latency")
 
             //! \brief fusion group match max iterations
@@ -120,6 +154,17 @@ namespace olympia
             //! \brief ...
             PARAMETER(FileNameListType, fusion_group_definitions, {},
                       "Lists of fusion group UID json files")
+
+            //! \brief use the fusion group tables generated at build time
+            //!
+            //! The tables are generated from FUSION_TABLE_JSON by the build,
+            //! fusion_group_definitions is ignored when true and should name
+            //! the same file, a warning is printed when it does not. Matching
+            //! uses the perfect hash index instead of a scan of all groups.
+            //! Builds without the tables (no Python) fall back to
+            //! fusion_group_definitions.
+            PARAMETER(bool, fusion_use_static_tables, false,
+                      "Use the build time generated fusion group tables")
         };
 
         /**
@@ -156,6 +201,50 @@ namespace olympia
         sparta::UniqueEvent<> ev_decode_insts_event_{&unit_event_set_, "decode_insts_event",
                                                      CREATE_SPARTA_HANDLER(Decode, decodeInsts_)};
 
+        //! \brief decode slot instruction classes, one bit each
+        enum DecodeClass : uint32_t
+        {
+            DECODE_CLASS_INT = 1 << 0,
+            DECODE_CLASS_MEM = 1 << 1,
+            DECODE_CLASS_FLOAT = 1 << 2,
+            DECODE_CLASS_BRANCH = 1 << 3,
+            DECODE_CLASS_COMPLEX = 1 << 4,
+            DECODE_CLASS_ALL = (1 << 5) - 1
+        };
+
+        //! \brief the yaml names of the decode classes
+        static const std::map<std::string, uint32_t> decode_class_map_;
+
+        //! \brief why a decode group was cut short of num_to_decode
+        enum class DecodeStall
+        {
+            NONE,
+            NO_INSTS,
+            NO_CREDITS,
+            SLOT_CLASS,
+            BRANCH_LIMIT,
+            THREAD_SWITCH
+        };
+
+        //! \brief convert decode_slot_classes to one class mask per slot
+        static std::vector<uint32_t> parseDecodeSlots_(const std::vector<std::string> & classes,
+                                                       uint32_t num_to_decode);
+
+        //! \brief the decode class of an instruction
+        uint32_t getDecodeClass_(const InstPtr & inst) const;
+
+        //! \brief find a slot for inst at or after next_slot
+        //!
+        //! Returns the slot or num_to_decode_ if no remaining slot
+        //! accepts the instruction class.
+        uint32_t findDecodeSlot_(const InstPtr & inst, uint32_t next_slot) const;
+
+        //! \brief count a decode group cut short by reason
+        void countDecodeStall_(DecodeStall reason);
+
+        //! \brief replace the cracked instructions in insts with their micro-ops
+        void crackInsts_(InstGroupPtr & insts);
+
         //! \brief initialize the fusion group configuration
         void constructFusionGroups_();
 
@@ -181,6 +270,20 @@ namespace olympia
         void matchFusionGroups_(MatchInfoListType & matches, InstGroupPtr & insts,
                                 InstUidListType & inputUIDS, FusionGroupContainerType &);
 
+        //! \brief compare the dynamic uid vector to the generated tables
+        //!
+        //! Same results as matchFusionGroups_. Every input segment up to
+        //! the longest group is looked up in the perfect hash index, the
+        //! segments from one start share a running hash. The cost does
+        //! not depend on the number of groups.
+        void matchStaticFusionGroups_(MatchInfoListType & matches,
+                                      const InstUidListType & inputUIDS);
+
+        //! \brief create the fusion group configs from the generated tables
+        //!
+        //! false if the build has no generated tables
+        bool constructStaticFusionGroups_(FusionGroupCfgListType &);
+
         //! \brief process the fusion matches
         void processMatches_(MatchInfoListType &, InstGroupPtr & insts,
                              const InstUidListType & inputUIDS);
@@ -218,6 +321,14 @@ namespace olympia
         //! \brief record stats for fusionGroup name
         void updateFusionGroupUtilization_(std::string name);
 
+        //! \brief number of trailing instructions to hold in the fetch queue
+        //!
+        //! The fusion window slides over the fetch queue. If the last
+        //! instructions of the candidate decode group form a proper prefix
+        //! of a fusion group they are left in the fetch queue so they can
+        //! be matched with their partners in a following decode cycle.
+        uint32_t fusionWindowHoldCount_(const uint32_t num_decode) const;
+
         //! \brief number of custom instructions created for fusion
         sparta::Counter fusion_num_fuse_instructions_;
 
@@ -252,9 +363,54 @@ namespace olympia
         //! of the defined fusion groups.
         sparta::Counter fusion_pred_cycles_saved_;
 
+        //! \brief fusions formed with instructions held in the fusion window
+        //!
+        //! Counts the fusion groups that would have been split across
+        //! decode groups without the fusion window.
+        sparta::Counter fusion_num_window_fusions_;
+
+        //! \brief cycles decode sent nothing while waiting on the fusion window
+        sparta::Counter fusion_window_stall_cycles_;
+
+        //! \brief number of instructions cracked into micro-ops
+        sparta::Counter num_cracked_insts_;
+
+        //! \brief number of micro-ops created by cracking
+        sparta::Counter num_cracked_uops_;
+
+        //! \brief decode groups cut short because the fetch queue ran dry
+        sparta::Counter decode_stall_no_insts_;
+
+        //! \brief decode groups cut short by uop queue credits
+        sparta::Counter decode_stall_no_credits_;
+
+        //! \brief decode groups cut short by no slot accepting the next class
+        sparta::Counter decode_stall_slot_class_;
+
+        //! \brief decode groups cut short by the per cycle branch limit
+        sparta::Counter decode_stall_branch_limit_;
+
+        //! \brief decode groups cut short by an instruction of another thread
+        sparta::Counter decode_stall_thread_switch_;
+
         //! \brief temporary for number of instructions to decode this time
         const uint32_t num_to_decode_;
 
+        //! \brief class mask of each decode slot
+        const std::vector<uint32_t> decode_slot_masks_;
+
+        //! \brief branches per decode group limit, 0 is unlimited
+        const uint32_t max_branches_per_cycle_;
+
+        //! \brief micro-op cracking enable
+        const bool enable_uop_cracking_;
+
+        //! \brief CSR read renaming enable
+        const bool rename_csr_reads_;
+
+        //! \brief allocator for the micro-ops created by cracking
+        InstAllocator & inst_allocator_;
+
         //! \brief master fusion enable data member
         //!
         //! This is the model's fusion enable parameter. When not enabled
@@ -285,6 +441,10 @@ namespace olympia
         //! experimenting with instruction gathering
         const uint32_t fusion_max_latency_{0};
 
+        //! \brief fusion groups come from the build time generated tables,
+        //! cleared when the build has none
+        bool fusion_use_static_tables_{false};
+
         //! \brief max attempts to match UIDs of instrs in the XIQ
         const uint32_t fusion_match_max_tries_{0};
 
@@ -294,8 +454,20 @@ namespace olympia
         uint32_t fusion_max_group_size_{0};
 
         //! \brief running count of fusion latency
+        //!
+        //! Consecutive decode cycles in which the candidate held_uid_
+        //! was held back by the fusion window
         uint32_t latency_count_{0};
 
+        //! \brief unique ID of the first instruction held by the window
+        uint64_t held_uid_{0};
+
+        //! \brief instructions at the head of the fetch queue held by the window
+        uint32_t num_held_insts_{0};
+
+        //! \brief proper prefixes of the UID lists of all fusion groups
+        std::set<InstUidListType> fusion_group_prefixes_;
+
         //! \brief the Fusion API instance
         //!
         //! \see Fusion.hpp
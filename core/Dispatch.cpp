@@ -1,6 +1,7 @@
 // <Dispatch.cpp> -*- C++ -*-
 
 #include <algorithm>
+#include <map>
 #include "CoreUtils.hpp"
 #include "Dispatch.hpp"
 #include "sparta/events/StartupEvent.hpp"
@@ -15,7 +16,10 @@ namespace olympia
         dispatch_queue_("dispatch_queue", p->dispatch_queue_depth, node->getClock(),
                         getStatisticSet()),
         num_to_dispatch_(p->num_to_dispatch),
-        dispatch_queue_depth_(p->dispatch_queue_depth)
+        dispatch_queue_depth_(p->dispatch_queue_depth),
+        unified_scheduler_size_(p->unified_scheduler_size),
+        criticality_predictor_(p->criticality_table_size, p->criticality_threshold, 3),
+        steering_policy_(parseSteeringPolicy_(p->steering_policy))
     {
         weighted_unit_distribution_context_.assignContextWeights(p->context_weights);
         dispatch_queue_.enableCollection(node);
@@ -78,8 +82,10 @@ namespace olympia
             auto & out_inst_port =
                 out_inst_ports_.emplace_back(new sparta::DataOutPort<InstQueue::value_type>(
                     &unit_port_set_, "out_" + iq_name + "_write"));
-            std::shared_ptr<Dispatcher> dispatcher = std::make_shared<Dispatcher>(
-                iq_name, this, info_logger_, in_credit_port.get(), out_inst_port.get());
+            std::shared_ptr<Dispatcher> dispatcher =
+                std::make_shared<Dispatcher>(iq_name, all_dispatchers_.size(), this, info_logger_,
+                                             in_credit_port.get(), out_inst_port.get());
+            all_dispatchers_.emplace_back(dispatcher.get());
 
             // store in dispatchers_ which issue queues map to which pipe target
             const auto pipe_target_start = std::stoi(iq[0]);
@@ -114,11 +120,43 @@ namespace olympia
             }
         }
 
+        num_issue_queues_ = all_dispatchers_.size();
+
         // Special case for the LSU
         dispatchers_[static_cast<size_t>(InstArchInfo::TargetPipe::LSU)].emplace_back(
-            new Dispatcher("lsu", this, info_logger_, &in_lsu_credits_, &out_lsu_write_));
+            new Dispatcher("lsu", all_dispatchers_.size(), this, info_logger_, &in_lsu_credits_,
+                           &out_lsu_write_));
+        all_dispatchers_.emplace_back(
+            dispatchers_[static_cast<size_t>(InstArchInfo::TargetPipe::LSU)].back().get());
         in_lsu_credits_.enableCollection(node);
 
+        // Steering statistics per dispatcher
+        for (const auto disp : all_dispatchers_)
+        {
+            const auto & disp_name = disp->getName();
+            steered_insts_.emplace_back(new sparta::Counter(
+                getStatisticSet(), "count_" + disp_name + "_steered",
+                "Instructions steered to " + disp_name, sparta::Counter::COUNT_NORMAL));
+            occupancy_sum_.emplace_back(new sparta::Counter(
+                getStatisticSet(), disp_name + "_occupancy",
+                "Occupancy of " + disp_name + " summed over the dispatch sessions",
+                sparta::Counter::COUNT_NORMAL));
+            avg_occupancy_.emplace_back(new sparta::StatisticDef(
+                getStatisticSet(), disp_name + "_avg_occupancy",
+                "Average occupancy of " + disp_name + " seen by dispatch", getStatisticSet(),
+                disp_name + "_occupancy / dispatch_sessions"));
+        }
+
+        // Physical registers are bounded by the scoreboard width
+        for (auto & producers : reg_producers_)
+        {
+            producers.resize(core_types::RegisterBitMask().size());
+        }
+        if (steering_policy_ == SteeringPolicy::LATENCY)
+        {
+            readSteeringLatencies_(node);
+        }
+
         in_reorder_credits_.registerConsumerHandler(
             CREATE_SPARTA_HANDLER_WITH_DATA(Dispatch, robCredits_, uint32_t));
         in_reorder_credits_.enableCollection(node);
@@ -127,10 +165,70 @@ namespace olympia
             Dispatch, handleFlush_, FlushManager::FlushingCriteria));
         in_reorder_flush_.enableCollection(node);
 
+        in_rob_critical_load_.registerConsumerHandler(
+            CREATE_SPARTA_HANDLER_WITH_DATA(Dispatch, trainCriticalLoad_, InstPtr));
+
         blocking_dispatcher_ = InstArchInfo::TargetPipe::INT;
         sparta::StartupEvent(node, CREATE_SPARTA_HANDLER(Dispatch, sendInitialCredits_));
     }
 
+    Dispatch::SteeringPolicy Dispatch::parseSteeringPolicy_(const std::string & policy)
+    {
+        static const std::map<std::string, SteeringPolicy> policies = {
+            {"first_fit", SteeringPolicy::FIRST_FIT},
+            {"least_occupied", SteeringPolicy::LEAST_OCCUPIED},
+            {"round_robin", SteeringPolicy::ROUND_ROBIN},
+            {"dependency", SteeringPolicy::DEPENDENCY},
+            {"latency", SteeringPolicy::LATENCY}};
+        const auto match = policies.find(policy);
+        sparta_assert(match != policies.end(), "Unknown steering_policy: " << policy);
+        return match->second;
+    }
+
+    void Dispatch::readSteeringLatencies_(sparta::TreeNode* node)
+    {
+        // The scoreboard latency matrix is labelled by unit name, the
+        // rows are producers and the columns consumers:
+        //   [["",    "lsu", "iq0"],
+        //    ["lsu", 1,     1    ],
+        //    ["iq0", 1,     1    ]]
+        for (uint32_t rf = 0; rf < core_types::N_REGFILES; ++rf)
+        {
+            const auto matrix =
+                sparta::notNull(node->getParent()->getChildAs<sparta::ParameterBase>(
+                                    std::string("rename.scoreboards.")
+                                    + core_types::regfile_names[rf] + ".params.latency_matrix"))
+                    ->getValueAs<std::vector<std::vector<std::string>>>();
+            sparta_assert(matrix.size() > 1, "Empty " << core_types::regfile_names[rf]
+                                                      << " latency_matrix, needed by the "
+                                                         "latency steering policy");
+            auto index_of = [&matrix](const std::string & unit, bool row)
+            {
+                for (uint32_t i = 1; i < matrix.size(); ++i)
+                {
+                    if ((row ? matrix[i][0] : matrix[0][i]) == unit)
+                    {
+                        return i;
+                    }
+                }
+                sparta_assert(false, "Unit " << unit << " is not in the latency_matrix");
+                return 0u;
+            };
+
+            auto & latency = steering_latency_[rf];
+            latency.resize(all_dispatchers_.size());
+            for (const auto producer : all_dispatchers_)
+            {
+                const auto row = index_of(producer->getName(), true);
+                for (const auto consumer : all_dispatchers_)
+                {
+                    const auto col = index_of(consumer->getName(), false);
+                    latency[producer->getId()].emplace_back(std::stoul(matrix[row][col]));
+                }
+            }
+        }
+    }
+
     void Dispatch::scheduleDispatchSession()
     {
         if (credits_rob_ > 0 && (dispatch_queue_.size() > 0))
@@ -200,6 +298,13 @@ namespace olympia
 
         // Stop the current counter
         stall_counters_[current_stall_].stopCounting();
+        if (hol_blocked_)
+        {
+            hol_blocked_cycles_.stopCounting();
+            hol_blocked_ = false;
+        }
+
+        sampleOccupancy_();
 
         if (num_dispatch == 0)
         {
@@ -216,14 +321,17 @@ namespace olympia
         for (uint32_t i = 0; (i < num_dispatch) && keep_dispatching; ++i)
         {
             bool dispatched = false;
+            bool scheduler_full = false;
             InstPtr & ex_inst_ptr = dispatch_queue_.access(0);
             Inst & ex_inst = *ex_inst_ptr;
             const auto target_pipe = ex_inst.getPipe();
 
             sparta_assert(target_pipe != InstArchInfo::TargetPipe::UNKNOWN,
                           "Have an instruction that doesn't know where to go: " << ex_inst);
+            ex_inst.setCritical(criticality_predictor_.isCritical(ex_inst.getPC()));
 
-            if (SPARTA_EXPECT_FALSE(target_pipe == InstArchInfo::TargetPipe::SYS))
+            if (SPARTA_EXPECT_FALSE(target_pipe == InstArchInfo::TargetPipe::SYS)
+                || ex_inst.isEliminated())
             {
                 ex_inst.setStatus(Inst::Status::COMPLETED);
                 // Indicate that this instruction was dispatched
@@ -246,23 +354,18 @@ namespace olympia
                                      "pipe. Did you define it in the yaml properly?");
                 // so we have a map here that checks for which valid dispatchers for that
                 // instruction target pipe map needs to be: "int": [exe0, exe1, exe2]
-                if (target_pipe != InstArchInfo::TargetPipe::LSU)
+                if ((target_pipe != InstArchInfo::TargetPipe::LSU) && !schedulerHasRoom_())
                 {
-                    uint32_t max_credits = 0;
-                    olympia::Dispatcher* best_dispatcher = nullptr;
-                    // find the dispatcher with the most amount of credits, i.e the issue queue with
-                    // the least amount of entries
-                    for (auto & dispatcher_iq : dispatchers)
-                    {
-                        if (dispatcher_iq->canAccept() && dispatcher_iq->getCredits() > max_credits)
-                        {
-                            best_dispatcher = dispatcher_iq.get();
-                            max_credits = dispatcher_iq->getCredits();
-                        }
-                    }
+                    ILOG("unified scheduler full, cannot accept inst: " << ex_inst_ptr);
+                    scheduler_full = true;
+                }
+                else if (target_pipe != InstArchInfo::TargetPipe::LSU)
+                {
+                    olympia::Dispatcher* best_dispatcher = steerInst_(ex_inst_ptr, dispatchers);
                     if (best_dispatcher != nullptr)
                     {
                         best_dispatcher->acceptInst(ex_inst_ptr);
+                        recordProducer_(ex_inst_ptr, best_dispatcher);
                         ++unit_distribution_[target_pipe];
                         ++unit_distribution_context_.context(target_pipe);
                         ++weighted_unit_distribution_context_.context(target_pipe);
@@ -281,6 +384,7 @@ namespace olympia
                         if (disp->canAccept())
                         {
                             disp->acceptInst(ex_inst_ptr);
+                            recordProducer_(ex_inst_ptr, disp.get());
                             ++unit_distribution_[target_pipe];
                             ++(unit_distribution_context_.context(target_pipe));
                             ++(weighted_unit_distribution_context_.context(target_pipe));
@@ -301,7 +405,8 @@ namespace olympia
                 }
                 if (false == dispatched)
                 {
-                    current_stall_ = static_cast<StallReason>(target_pipe);
+                    current_stall_ = scheduler_full ? SCHEDULER_FULL
+                                                    : static_cast<StallReason>(target_pipe);
                     keep_dispatching = false;
                 }
             }
@@ -309,6 +414,10 @@ namespace olympia
             if (dispatched)
             {
                 insts_dispatched->emplace_back(ex_inst_ptr);
+                if (ex_inst.isCritical())
+                {
+                    ++critical_insts_dispatched_;
+                }
                 dispatch_queue_.pop();
                 --credits_rob_;
             }
@@ -326,6 +435,14 @@ namespace olympia
             }
         }
 
+        // Younger instructions held back by the head's full issue queue
+        if ((current_stall_ != NOT_STALLED) && (current_stall_ != SCHEDULER_FULL)
+            && youngerCanDispatch_())
+        {
+            hol_blocked_cycles_.startCounting();
+            hol_blocked_ = true;
+        }
+
         if (!insts_dispatched->empty())
         {
             out_dispatch_queue_credits_.send(static_cast<uint32_t>(insts_dispatched->size()));
@@ -340,11 +457,273 @@ namespace olympia
         stall_counters_[current_stall_].startCounting();
     }
 
+    bool Dispatch::schedulerHasRoom_() const
+    {
+        if (unified_scheduler_size_ == 0)
+        {
+            return true;
+        }
+        uint32_t occupancy = 0;
+        for (uint32_t id = 0; id < num_issue_queues_; ++id)
+        {
+            occupancy += all_dispatchers_[id]->getOccupancy();
+        }
+        return occupancy < unified_scheduler_size_;
+    }
+
+    bool Dispatch::youngerCanDispatch_() const
+    {
+        const auto head_pipe = dispatch_queue_.read(0)->getPipe();
+        const uint32_t window =
+            std::min({dispatch_queue_.size(), num_to_dispatch_, credits_rob_});
+        for (uint32_t i = 1; i < window; ++i)
+        {
+            const auto & inst = dispatch_queue_.read(i);
+            const auto pipe = inst->getPipe();
+            if ((pipe == InstArchInfo::TargetPipe::SYS) || inst->isEliminated())
+            {
+                return true;
+            }
+            if ((pipe == head_pipe)
+                || ((pipe != InstArchInfo::TargetPipe::LSU) && !schedulerHasRoom_()))
+            {
+                continue;
+            }
+            for (const auto & disp : dispatchers_[static_cast<size_t>(pipe)])
+            {
+                if (disp->canAccept())
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
     void Dispatch::handleFlush_(const FlushManager::FlushingCriteria & criteria)
     {
         ILOG("Got a flush call for " << criteria);
-        out_dispatch_queue_credits_.send(dispatch_queue_.size());
+
+        // Instructions of the other threads stay queued
+        std::vector<InstPtr> survivors;
+        for (const auto & inst : dispatch_queue_)
+        {
+            if (!criteria.includedInFlush(inst)) {
+                survivors.emplace_back(inst);
+            }
+        }
+        out_dispatch_queue_credits_.send(dispatch_queue_.size() - survivors.size());
         dispatch_queue_.clear();
-        out_reorder_write_.cancel();
+        for (const auto & inst : survivors) {
+            dispatch_queue_.push(inst);
+        }
+        out_reorder_write_.cancelIf([&criteria](const InstGroupPtr & grp) {
+            grp->erase(std::remove_if(grp->begin(), grp->end(),
+                                      [&criteria](const InstPtr & inst) {
+                                          return criteria.includedInFlush(inst);
+                                      }),
+                       grp->end());
+            return grp->empty();
+        });
+
+        if (criteria.getCause() == FlushManager::FlushCause::MISPREDICTION)
+        {
+            trainBranchProducers_(criteria.getInstPtr());
+        }
+
+        // Flushed producers will not write their registers
+        for (auto & producers : reg_producers_)
+        {
+            for (auto & producer : producers)
+            {
+                if (producer.inst && criteria.includedInFlush(producer.inst)) {
+                    producer = RegProducer();
+                }
+            }
+        }
+
+        if (!dispatch_queue_.empty()) {
+            ev_dispatch_insts_.schedule(1);
+        }
+    }
+
+    void Dispatch::trainCriticalLoad_(const InstPtr & load)
+    {
+        if (criticality_predictor_.isEnabled())
+        {
+            ILOG("critical load: " << load);
+            criticality_predictor_.train(load->getPC());
+            ++critical_load_trainings_;
+        }
+    }
+
+    // The producers of a mispredicted branch's sources delayed its
+    // resolution. They are older than the branch, so still recorded.
+    void Dispatch::trainBranchProducers_(const InstPtr & branch)
+    {
+        if (!criticality_predictor_.isEnabled())
+        {
+            return;
+        }
+        for (const auto & src : branch->getRenameData().getSourceList())
+        {
+            if ((src.rf == core_types::RF_INVALID) || src.is_x0)
+            {
+                continue;
+            }
+            const RegProducer & producer = reg_producers_[src.rf][src.val];
+            if (producer.inst != nullptr)
+            {
+                ILOG("critical producer: " << producer.inst << " of " << branch);
+                criticality_predictor_.train(producer.inst->getPC());
+                ++critical_producer_trainings_;
+            }
+        }
+    }
+
+    Dispatcher* Dispatch::steerInst_(const InstPtr & inst,
+                                     const std::vector<std::shared_ptr<Dispatcher>> & dispatchers)
+    {
+        // The dispatcher with the most credits, i.e the issue queue with
+        // the least amount of entries. The fallback of the other policies
+        auto least_occupied = [&dispatchers]() -> Dispatcher*
+        {
+            uint32_t max_credits = 0;
+            Dispatcher* best_dispatcher = nullptr;
+            for (auto & dispatcher_iq : dispatchers)
+            {
+                if (dispatcher_iq->canAccept() && dispatcher_iq->getCredits() > max_credits)
+                {
+                    best_dispatcher = dispatcher_iq.get();
+                    max_credits = dispatcher_iq->getCredits();
+                }
+            }
+            return best_dispatcher;
+        };
+
+        switch (steering_policy_)
+        {
+        case SteeringPolicy::FIRST_FIT:
+            for (auto & dispatcher_iq : dispatchers)
+            {
+                if (dispatcher_iq->canAccept())
+                {
+                    return dispatcher_iq.get();
+                }
+            }
+            return nullptr;
+        case SteeringPolicy::LEAST_OCCUPIED:
+            return least_occupied();
+        case SteeringPolicy::ROUND_ROBIN:
+        {
+            auto & next = rr_next_dispatcher_[static_cast<size_t>(inst->getPipe())];
+            for (uint32_t i = 0; i < dispatchers.size(); ++i)
+            {
+                const uint32_t idx = (next + i) % dispatchers.size();
+                if (dispatchers[idx]->canAccept())
+                {
+                    next = (idx + 1) % dispatchers.size();
+                    return dispatchers[idx].get();
+                }
+            }
+            return nullptr;
+        }
+        case SteeringPolicy::DEPENDENCY:
+            // Follow the first in-flight producer whose queue can take inst
+            for (const auto & src : inst->getRenameData().getSourceList())
+            {
+                const RegProducer* producer = findProducer_(src);
+                if (producer == nullptr)
+                {
+                    continue;
+                }
+                for (auto & dispatcher_iq : dispatchers)
+                {
+                    if ((dispatcher_iq->getId() == producer->dispatcher_id)
+                        && dispatcher_iq->canAccept())
+                    {
+                        ++steered_to_producer_;
+                        return dispatcher_iq.get();
+                    }
+                }
+            }
+            return least_occupied();
+        case SteeringPolicy::LATENCY:
+        {
+            // Lowest worst-case operand latency, ties to the most credits
+            Dispatcher* best_dispatcher = nullptr;
+            uint32_t best_latency = 0;
+            for (auto & dispatcher_iq : dispatchers)
+            {
+                if (!dispatcher_iq->canAccept())
+                {
+                    continue;
+                }
+                const uint32_t latency = operandLatency_(inst, dispatcher_iq->getId());
+                if ((best_dispatcher == nullptr) || (latency < best_latency)
+                    || ((latency == best_latency)
+                        && (dispatcher_iq->getCredits() > best_dispatcher->getCredits())))
+                {
+                    best_dispatcher = dispatcher_iq.get();
+                    best_latency = latency;
+                }
+            }
+            return best_dispatcher;
+        }
+        }
+        return nullptr;
+    }
+
+    const Dispatch::RegProducer* Dispatch::findProducer_(const Inst::RenameData::Reg & src) const
+    {
+        if (src.rf == core_types::RF_INVALID || src.is_x0)
+        {
+            return nullptr;
+        }
+        const RegProducer & producer = reg_producers_[src.rf][src.val];
+        if (producer.inst == nullptr)
+        {
+            return nullptr;
+        }
+        // Done producers no longer constrain the consumer
+        const auto status = producer.inst->getStatus();
+        if ((status != Inst::Status::DISPATCHED) && (status != Inst::Status::SCHEDULED))
+        {
+            return nullptr;
+        }
+        return &producer;
+    }
+
+    uint32_t Dispatch::operandLatency_(const InstPtr & inst, const uint32_t consumer) const
+    {
+        uint32_t latency = 0;
+        for (const auto & src : inst->getRenameData().getSourceList())
+        {
+            if (const RegProducer* producer = findProducer_(src))
+            {
+                latency =
+                    std::max(latency, steering_latency_[src.rf][producer->dispatcher_id][consumer]);
+            }
+        }
+        return latency;
+    }
+
+    void Dispatch::recordProducer_(const InstPtr & inst, const Dispatcher* dispatcher)
+    {
+        ++(*steered_insts_[dispatcher->getId()]);
+        const auto & dest = inst->getRenameData().getDestination();
+        if (dest.rf != core_types::RF_INVALID)
+        {
+            reg_producers_[dest.rf][dest.val] = {inst, dispatcher->getId()};
+        }
+    }
+
+    void Dispatch::sampleOccupancy_()
+    {
+        ++dispatch_sessions_;
+        for (const auto disp : all_dispatchers_)
+        {
+            *occupancy_sum_[disp->getId()] += disp->getOccupancy();
+        }
     }
 } // namespace olympia
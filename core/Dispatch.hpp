@@ -15,12 +15,14 @@
 #include "sparta/statistics/Counter.hpp"
 #include "sparta/statistics/ContextCounter.hpp"
 #include "sparta/statistics/WeightedContextCounter.hpp"
+#include "sparta/statistics/StatisticDef.hpp"
 #include "sparta/simulation/ResourceFactory.hpp"
 
 #include "Dispatcher.hpp"
 #include "CoreTypes.hpp"
 #include "InstGroup.hpp"
 #include "FlushManager.hpp"
+#include "CriticalityPredictor.hpp"
 
 namespace olympia
 {
@@ -46,6 +48,20 @@ namespace olympia
             PARAMETER(uint32_t, dispatch_queue_depth, 10, "Depth of the dispatch buffer")
             PARAMETER(std::vector<double>, context_weights, std::vector<double>(1, 1),
                       "Relative weight of each context")
+            PARAMETER(std::string, steering_policy, "least_occupied",
+                      "Issue queue chosen for a target pipe served by several: 'first_fit', "
+                      "'least_occupied', 'round_robin', 'dependency' (the queue of an in-flight "
+                      "producer) or 'latency' (lowest producer to consumer latency in the "
+                      "scoreboard latency_matrix)")
+            PARAMETER(uint32_t, unified_scheduler_size, 0,
+                      "Entries of a scheduler pool shared by the issue queues, allocated to "
+                      "any pipe type on demand: each issue queue can hold up to the whole pool "
+                      "(replacing its scheduler_size). 0 keeps the issue queues distributed")
+            PARAMETER(uint32_t, criticality_table_size, 0,
+                      "Entries of the PC indexed criticality predictor, a power of 2. Critical "
+                      "instructions are issued ahead of older ones. 0 disables the predictor")
+            PARAMETER(uint32_t, criticality_threshold, 2,
+                      "Count (of 3) at which an instruction is predicted critical")
         };
 
         /**
@@ -93,12 +109,20 @@ namespace olympia
 
         std::array<std::vector<std::shared_ptr<Dispatcher>>, InstArchInfo::N_TARGET_PIPES>
             dispatchers_;
+
+        // All dispatchers, indexed by Dispatcher::getId()
+        std::vector<Dispatcher*> all_dispatchers_;
         InstArchInfo::TargetPipe blocking_dispatcher_ = InstArchInfo::TargetPipe::UNKNOWN;
 
         // For flush
         sparta::DataInPort<FlushManager::FlushingCriteria> in_reorder_flush_{
             &unit_port_set_, "in_reorder_flush", sparta::SchedulingPhase::Flush, 1};
 
+        // Loads at the head of the ROB while it stalls, to train the
+        // criticality predictor
+        sparta::DataInPort<InstPtr> in_rob_critical_load_{&unit_port_set_,
+                                                          "in_rob_critical_load", 1};
+
         // Tick events
         sparta::SingleCycleUniqueEvent<> ev_dispatch_insts_{
             &unit_event_set_, "dispatch_event",
@@ -108,6 +132,75 @@ namespace olympia
         uint32_t credits_rob_ = 0;
         uint32_t dispatch_queue_depth_;
 
+        ///////////////////////////////////////////////////////////////////////
+        // Unified scheduler, the issue queues are the first
+        // num_issue_queues_ dispatchers
+        const uint32_t unified_scheduler_size_;
+        uint32_t num_issue_queues_ = 0;
+
+        // The shared pool has a free entry, always true when distributed
+        bool schedulerHasRoom_() const;
+
+        // A younger instruction in the dispatch window could be sent
+        // while the head is stalled on its pipe
+        bool youngerCanDispatch_() const;
+        bool hol_blocked_ = false;
+
+        ///////////////////////////////////////////////////////////////////////
+        // Criticality prediction, trained by the loads stalling the ROB
+        // and the producers of mispredicted branches
+        CriticalityPredictor criticality_predictor_;
+        void trainCriticalLoad_(const InstPtr & load);
+        void trainBranchProducers_(const InstPtr & branch);
+
+        ///////////////////////////////////////////////////////////////////////
+        // Issue queue steering
+        enum class SteeringPolicy
+        {
+            FIRST_FIT,
+            LEAST_OCCUPIED,
+            ROUND_ROBIN,
+            DEPENDENCY,
+            LATENCY
+        };
+        const SteeringPolicy steering_policy_;
+        static SteeringPolicy parseSteeringPolicy_(const std::string & policy);
+
+        // Next dispatcher to try per target pipe, round robin
+        std::array<uint32_t, InstArchInfo::N_TARGET_PIPES> rr_next_dispatcher_{};
+
+        // Last dispatched producer of each physical register, the
+        // dependency and latency policies follow it while it is in flight
+        struct RegProducer
+        {
+            InstPtr inst;
+            uint32_t dispatcher_id = 0;
+        };
+        std::array<std::vector<RegProducer>, core_types::N_REGFILES> reg_producers_;
+
+        // Producer to consumer latency, [rf][producer id][consumer id],
+        // from the scoreboard latency matrices
+        std::array<std::vector<std::vector<uint32_t>>, core_types::N_REGFILES> steering_latency_;
+
+        // Choose the dispatcher for inst among those serving its pipe
+        Dispatcher* steerInst_(const InstPtr & inst,
+                               const std::vector<std::shared_ptr<Dispatcher>> & dispatchers);
+
+        // Dispatcher of an in-flight producer of a source of inst, or nullptr
+        const RegProducer* findProducer_(const Inst::RenameData::Reg & src) const;
+
+        // Worst latency of inst's in-flight operands if issued from consumer
+        uint32_t operandLatency_(const InstPtr & inst, const uint32_t consumer) const;
+
+        // Remember inst as the producer of its destination
+        void recordProducer_(const InstPtr & inst, const Dispatcher* dispatcher);
+
+        // Read the scoreboard latency matrices for the latency policy
+        void readSteeringLatencies_(sparta::TreeNode* node);
+
+        // Per issue queue occupancy, sampled each dispatch session
+        void sampleOccupancy_();
+
         // Send rename initial credits
         void sendInitialCredits_();
 
@@ -147,7 +240,16 @@ namespace olympia
                 InstArchInfo::TargetPipe::MUL, // Could not send any or all instructions -- MUL busy
             BR_BUSY =
                 InstArchInfo::TargetPipe::BR, // Could not send any or all instructions -- MUL busy
+            VINT_BUSY = InstArchInfo::TargetPipe::VINT, // Could not send any or all instructions
+                                                        // -- VINT busy
+            VMUL_BUSY = InstArchInfo::TargetPipe::VMUL, // Could not send any or all instructions
+                                                        // -- VMUL busy
+            VDIV_BUSY = InstArchInfo::TargetPipe::VDIV, // Could not send any or all instructions
+                                                        // -- VDIV busy
+            CSR_BUSY = InstArchInfo::TargetPipe::CSR, // Could not send any or all instructions
+                                                      // -- CSR busy
             NO_ROB_CREDITS = InstArchInfo::TargetPipe::SYS, // No credits from the ROB
+            SCHEDULER_FULL, // Unified scheduler pool has no free entry
             NOT_STALLED, // Made forward progress (dispatched all instructions or no instructions)
             N_STALL_REASONS
         };
@@ -180,8 +282,19 @@ namespace olympia
                                   sparta::Counter::COUNT_NORMAL, getClock()),
              sparta::CycleCounter(getStatisticSet(), "stall_br_busy", "BR busy",
                                   sparta::Counter::COUNT_NORMAL, getClock()),
+             sparta::CycleCounter(getStatisticSet(), "stall_vint_busy", "VINT busy",
+                                  sparta::Counter::COUNT_NORMAL, getClock()),
+             sparta::CycleCounter(getStatisticSet(), "stall_vmul_busy", "VMUL busy",
+                                  sparta::Counter::COUNT_NORMAL, getClock()),
+             sparta::CycleCounter(getStatisticSet(), "stall_vdiv_busy", "VDIV busy",
+                                  sparta::Counter::COUNT_NORMAL, getClock()),
+             sparta::CycleCounter(getStatisticSet(), "stall_csr_busy", "CSR busy",
+                                  sparta::Counter::COUNT_NORMAL, getClock()),
              sparta::CycleCounter(getStatisticSet(), "stall_sys_busy", "No credits from ROB",
                                   sparta::Counter::COUNT_NORMAL, getClock()),
+             sparta::CycleCounter(getStatisticSet(), "stall_scheduler_full",
+                                  "Unified scheduler pool full",
+                                  sparta::Counter::COUNT_NORMAL, getClock()),
              sparta::CycleCounter(getStatisticSet(), "stall_not_stalled",
                                   "Dispatch not stalled, all instructions dispatched",
                                   sparta::Counter::COUNT_NORMAL, getClock())}};
@@ -209,6 +322,14 @@ namespace olympia
                              sparta::Counter::COUNT_NORMAL),
              sparta::Counter(getStatisticSet(), "count_br_insts", "Total BR insts",
                              sparta::Counter::COUNT_NORMAL),
+             sparta::Counter(getStatisticSet(), "count_vint_insts", "Total VINT insts",
+                             sparta::Counter::COUNT_NORMAL),
+             sparta::Counter(getStatisticSet(), "count_vmul_insts", "Total VMUL insts",
+                             sparta::Counter::COUNT_NORMAL),
+             sparta::Counter(getStatisticSet(), "count_vdiv_insts", "Total VDIV insts",
+                             sparta::Counter::COUNT_NORMAL),
+             sparta::Counter(getStatisticSet(), "count_csr_insts", "Total renamed CSR reads",
+                             sparta::Counter::COUNT_NORMAL),
              sparta::Counter(getStatisticSet(), "count_sys_insts", "Total SYS insts",
                              sparta::Counter::COUNT_NORMAL)}};
 
@@ -249,16 +370,49 @@ namespace olympia
             "dispatch_int_inst_count",
             sparta::CounterBase::COUNT_NORMAL,
             sparta::InstrumentationNode::VIS_NORMAL};
+        // Instructions steered to each dispatcher and its occupancy
+        // summed over the dispatch sessions, by Dispatcher::getId()
+        std::vector<std::unique_ptr<sparta::Counter>> steered_insts_;
+        std::vector<std::unique_ptr<sparta::Counter>> occupancy_sum_;
+        std::vector<std::unique_ptr<sparta::StatisticDef>> avg_occupancy_;
+        sparta::Counter dispatch_sessions_{getStatisticSet(), "dispatch_sessions",
+                                           "Dispatch sessions, occupancy samples",
+                                           sparta::Counter::COUNT_NORMAL};
+        sparta::CycleCounter hol_blocked_cycles_{
+            getStatisticSet(), "hol_blocked_cycles",
+            "Cycles the head instruction's full issue queue held back a younger instruction "
+            "whose queue had room",
+            sparta::Counter::COUNT_NORMAL, getClock()};
+        sparta::Counter critical_insts_dispatched_{
+            getStatisticSet(), "critical_insts_dispatched",
+            "Instructions dispatched predicted critical", sparta::Counter::COUNT_NORMAL};
+        sparta::Counter critical_load_trainings_{
+            getStatisticSet(), "critical_load_trainings",
+            "Criticality trainings by a load heading a stalled ROB",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter critical_producer_trainings_{
+            getStatisticSet(), "critical_producer_trainings",
+            "Criticality trainings by a producer of a mispredicted branch",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter steered_to_producer_{
+            getStatisticSet(), "steered_to_producer",
+            "Instructions steered to the issue queue of an in-flight producer",
+            sparta::Counter::COUNT_NORMAL};
+
         sparta::StatisticDef total_insts_{
             getStatisticSet(), "count_total_insts_dispatched",
             "Total number of instructions dispatched", getStatisticSet(),
             "count_cmov_insts + count_div_insts + count_faddsub_insts + count_float_insts + "
             "count_fmac_insts + count_i2f_insts + count_f2i_insts + count_int_insts + "
-            "count_lsu_insts + count_mul_insts + count_br_insts"};
+            "count_lsu_insts + count_mul_insts + count_br_insts + count_vint_insts + "
+            "count_vmul_insts + count_vdiv_insts + count_csr_insts"};
+
+        friend class DispatchTester;
     };
 
     using DispatchFactory =
         sparta::ResourceFactory<olympia::Dispatch, olympia::Dispatch::DispatchParameterSet>;
+    class DispatchTester;
 
     inline std::ostream & operator<<(std::ostream & os, const Dispatch::StallReason & stall)
     {
@@ -270,6 +424,9 @@ namespace olympia
         case Dispatch::StallReason::NO_ROB_CREDITS:
             os << "NO_ROB_CREDITS";
             break;
+        case Dispatch::StallReason::SCHEDULER_FULL:
+            os << "SCHEDULER_FULL";
+            break;
         case Dispatch::StallReason::LSU_BUSY:
             os << "LSU_BUSY";
             break;
@@ -303,6 +460,18 @@ namespace olympia
         case Dispatch::StallReason::BR_BUSY:
             os << "BR_BUSY";
             break;
+        case Dispatch::StallReason::VINT_BUSY:
+            os << "VINT_BUSY";
+            break;
+        case Dispatch::StallReason::VMUL_BUSY:
+            os << "VMUL_BUSY";
+            break;
+        case Dispatch::StallReason::VDIV_BUSY:
+            os << "VDIV_BUSY";
+            break;
+        case Dispatch::StallReason::CSR_BUSY:
+            os << "CSR_BUSY";
+            break;
         case Dispatch::StallReason::N_STALL_REASONS:
             sparta_assert(false, "How'd we get here?");
         }
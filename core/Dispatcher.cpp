@@ -1,4 +1,6 @@
 
+#include <algorithm>
+
 #include "Dispatcher.hpp"
 #include "Dispatch.hpp"
 
@@ -6,6 +8,7 @@ namespace olympia
 {
     void Dispatcher::receiveCredits_(const uint32_t & credits) {
         unit_credits_ += credits;
+        capacity_ = std::max(capacity_, unit_credits_);
         ILOG(name_ << " got " << credits << " credits, total: " << unit_credits_);
 
         dispatch_->scheduleDispatchSession();
@@ -30,11 +30,13 @@ namespace olympia
     public:
         // Create a dispatcher
         Dispatcher(const std::string            & name,
+                   const uint32_t                 id,
                    Dispatch                     * dispatch,
                    sparta::log::MessageSource   & info_logger,
                    sparta::DataInPort<uint32_t> * in_credits,
                    sparta::DataOutPort<InstQueue::value_type> * out_inst) :
             name_(name),
+            id_(id),
             dispatch_(dispatch),
             info_logger_(info_logger),
             out_inst_(out_inst)
@@ -48,6 +50,11 @@ namespace olympia
             return name_;
         }
 
+        // Index of this dispatcher in Dispatch's steering tables
+        uint32_t getId() const {
+            return id_;
+        }
+
         // Can this dispatcher accept a new instruction?
         bool canAccept() const {
             // The dispatcher must be have enough credits in the
@@ -72,11 +79,17 @@ namespace olympia
 
         uint32_t getCredits() const {return unit_credits_;}
 
+        // Entries in use in the execution unit, the capacity is the
+        // most credits ever held (the initial credits)
+        uint32_t getOccupancy() const {return capacity_ - unit_credits_;}
+
     private:
         uint32_t unit_credits_ = 0;
+        uint32_t capacity_ = 0;
         uint32_t num_can_dispatch_ = 1;
 
         const std::string            name_;
+        const uint32_t               id_;
         Dispatch                   * dispatch_ = nullptr;
         sparta::log::MessageSource & info_logger_;
 
@@ -6,7 +6,19 @@
 
 namespace olympia
 {
-    Execute::Execute(sparta::TreeNode* node, const ExecuteParameterSet*) : sparta::Unit(node) {}
+    Execute::Execute(sparta::TreeNode* node, const ExecuteParameterSet* p) :
+        sparta::Unit(node),
+        bypass_(olympia::coreutils::getExePipeNames(node->getParent()),
+                olympia::coreutils::getPipeTopology(node->getParent(), "bypass_network"),
+                olympia::coreutils::getCoreValue(node->getParent(), "register_file_latency"),
+                p->bypass_window),
+        rf_ports_({p->int_rf_read_ports, p->float_rf_read_ports, p->vector_rf_read_ports},
+                  {p->int_rf_write_ports, p->float_rf_write_ports, p->vector_rf_write_ports},
+                  bypass_),
+        issue_arbiter_(olympia::coreutils::getExePipeNames(node->getParent()).size(),
+                       p->issue_arbitration)
+    {
+    }
 
     void ExecuteFactory::onConfiguring(sparta::ResourceTreeNode* node)
     {
@@ -107,6 +119,38 @@ namespace olympia
         auto pipelines = olympia::coreutils::getPipeTopology(node->getParent(), "pipelines");
         std::unordered_map<std::string, int> exe_pipe_to_iq_number;
 
+        // With a unified scheduler (Dispatch) any issue queue's
+        // partition can grow to the whole pool, Dispatch keeps the total
+        // within it
+        const auto unified_scheduler_size = node->getParent()->getChildAs<sparta::ParameterBase>(
+            "dispatch.params.unified_scheduler_size", false);
+        const uint32_t pool_size = (unified_scheduler_size != nullptr)
+                                     ? unified_scheduler_size->getValueAs<uint32_t>()
+                                     : 0;
+
+        // Every issue queue and pipe arbitrates the same register file
+        // ports and pipes, and shares the bypass network
+        auto execute = node->getResourceAs<olympia::Execute*>();
+        for (const auto & issue_queue : issue_queues_)
+        {
+            auto iq = issue_queue->getResourceAs<olympia::IssueQueue*>();
+            if (pool_size != 0)
+            {
+                iq->setSchedulerSize(pool_size);
+            }
+            iq->setRegisterFilePorts(execute->getRegisterFilePorts());
+            iq->setBypassNetwork(execute->getBypassNetwork());
+            iq->setIssueArbiter(execute->getIssueArbiter());
+            execute->getIssueArbiter()->addIssueQueue(iq);
+        }
+        for (const auto & exe_pipe_tns : exe_pipe_tns_)
+        {
+            auto exe_pipe = exe_pipe_tns->getResourceAs<olympia::ExecutePipe*>();
+            exe_pipe->setRegisterFilePorts(execute->getRegisterFilePorts());
+            exe_pipe->setBypassNetwork(execute->getBypassNetwork());
+            exe_pipe->setIssueArbiter(execute->getIssueArbiter());
+        }
+
         for (size_t iq_num = 0; iq_num < issue_queue_to_pipe_map_.size(); ++iq_num)
         {
             auto iq = issue_queue_to_pipe_map_[iq_num];
@@ -8,6 +8,9 @@
 #include "Inst.hpp"
 #include "ExecutePipe.hpp"
 #include "IssueQueue.hpp"
+#include "BypassNetwork.hpp"
+#include "RegisterFilePorts.hpp"
+#include "IssueArbiter.hpp"
 
 namespace olympia
 {
@@ -28,6 +31,25 @@ namespace olympia
         {
           public:
             ExecuteParameterSet(sparta::TreeNode* n) : sparta::ParameterSet(n) {}
+            PARAMETER(uint32_t, int_rf_read_ports, 0,
+                      "Integer register file read ports, 0 for unlimited")
+            PARAMETER(uint32_t, int_rf_write_ports, 0,
+                      "Integer register file write ports, 0 for unlimited")
+            PARAMETER(uint32_t, float_rf_read_ports, 0,
+                      "Float register file read ports, 0 for unlimited")
+            PARAMETER(uint32_t, float_rf_write_ports, 0,
+                      "Float register file write ports, 0 for unlimited")
+            PARAMETER(uint32_t, vector_rf_read_ports, 0,
+                      "Vector register file read ports, 0 for unlimited")
+            PARAMETER(uint32_t, vector_rf_write_ports, 0,
+                      "Vector register file write ports, 0 for unlimited")
+            PARAMETER(uint32_t, bypass_window, 1,
+                      "Cycles a result stays on the bypass network past its forwarding stage, "
+                      "a source captured from it does not use a register file read port")
+            PARAMETER(std::string, issue_arbitration, "per_queue",
+                      "Selection of the ready instructions: 'per_queue' (each issue queue "
+                      "alone) or 'oldest_first' (every issue queue of the core by age, the "
+                      "queues' in_order_issue is not used)")
         };
 
         /**
@@ -40,6 +62,20 @@ namespace olympia
 
         //! \brief Name of this resource. Required by sparta::UnitFactory
         static constexpr char name[] = "execute";
+
+        //! \brief Register file ports shared by the issue queues and pipes
+        RegisterFilePorts* getRegisterFilePorts() { return &rf_ports_; }
+
+        //! \brief Forwarding paths between the pipes
+        BypassNetwork* getBypassNetwork() { return &bypass_; }
+
+        //! \brief Pipe readiness and selection across the issue queues
+        IssueArbiter* getIssueArbiter() { return &issue_arbiter_; }
+
+      private:
+        BypassNetwork bypass_;
+        RegisterFilePorts rf_ports_;
+        IssueArbiter issue_arbiter_;
     };
 
     //! Execute's factory class.  Don't create Execute without it
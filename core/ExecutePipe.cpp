@@ -5,6 +5,8 @@
 #include "sparta/utils/LogUtils.hpp"
 #include "sparta/utils/SpartaAssert.hpp"
 
+#include <algorithm>
+
 namespace olympia
 {
     const char ExecutePipe::name[] = "exe_pipe";
@@ -13,11 +15,17 @@ namespace olympia
         sparta::Unit(node),
         ignore_inst_execute_time_(p->ignore_inst_execute_time),
         execute_time_(p->execute_time),
+        enable_pipelining_(p->enable_pipelining),
+        early_out_bits_per_cycle_(p->early_out_bits_per_cycle),
+        early_out_overhead_(p->early_out_overhead),
+        engines_(p->num_iterative_engines),
         enable_random_misprediction_(p->enable_random_misprediction && p->contains_branch_unit),
+        resolve_branches_at_execute_(p->resolve_branches_at_execute && p->contains_branch_unit),
         issue_queue_name_(p->iq_name),
         collected_inst_(node, node->getName())
     {
         p->enable_random_misprediction.ignore();
+        p->resolve_branches_at_execute.ignore();
         p->contains_branch_unit.ignore();
         in_reorder_flush_.registerConsumerHandler(CREATE_SPARTA_HANDLER_WITH_DATA(
             ExecutePipe, flushInst_, FlushManager::FlushingCriteria));
@@ -30,7 +38,8 @@ namespace olympia
     void ExecutePipe::setupExecutePipe_()
     {
         // Setup scoreboard view upon register file
-        std::vector<core_types::RegFile> reg_files = {core_types::RF_INTEGER, core_types::RF_FLOAT};
+        std::vector<core_types::RegFile> reg_files = {core_types::RF_INTEGER, core_types::RF_FLOAT,
+                                                      core_types::RF_VECTOR};
         // if we ever move to multicore, we only want to have resources look for
         // scoreboard in their cpu if we're running a test where we only have
         // top.rename or top.issue_queue, then we can just use the root
@@ -54,29 +63,139 @@ namespace olympia
     void ExecutePipe::insertInst(const InstPtr & ex_inst)
     {
         sparta_assert_context(
-            unit_busy_ == false,
-            "ExecutePipe is receiving a new instruction when it's already busy!!");
+            canAccept(), "ExecutePipe is receiving a new instruction when it's already busy!!");
         ex_inst->setStatus(Inst::Status::SCHEDULED);
-        const uint32_t exe_time =
-            ignore_inst_execute_time_ ? execute_time_ : ex_inst->getExecuteTime();
+        const uint32_t exe_time = earlyOutTime_(
+            ex_inst, ignore_inst_execute_time_ ? execute_time_ : ex_inst->getExecuteTime());
         collected_inst_.collectWithDuration(ex_inst, exe_time);
         ILOG("Executing: " << ex_inst << " for " << exe_time + getClock()->currentCycle());
         sparta_assert(exe_time != 0);
 
-        unit_busy_ = true;
+        // A pipelined instruction frees the unit after its initiation
+        // interval, a non-pipelined one (div, sqrt) once it executes
+        uint32_t interval =
+            enable_pipelining_ ? std::min(ex_inst->getInitiationInterval(), exe_time) : exe_time;
+        if (!engines_.empty() && !ex_inst->getInstArchInfo()->isPipelined())
+        {
+            // Drains in an iterative engine, the pipe takes the next
+            // instruction next cycle
+            const auto engine = std::find_if(engines_.begin(), engines_.end(), isEngineFree_);
+            sparta_assert(engine != engines_.end(),
+                          "No free iterative engine for " << ex_inst);
+            *engine = ex_inst;
+            interval = 1;
+            ++iterative_insts_;
+        }
+        setBusyUntil_(getClock()->currentCycle() + interval);
+        busy_inst_ = ex_inst;
+        if (interval < exe_time)
+        {
+            unit_free_.schedule(interval);
+        }
         execute_inst_.preparePayload(ex_inst)->schedule(exe_time);
     }
 
+    // Shorten the latency of an early-out instruction (integer divide)
+    // to its quotient bits, from the leading zeros of the operands
+    uint32_t ExecutePipe::earlyOutTime_(const InstPtr & ex_inst, const uint32_t exe_time)
+    {
+        const auto & arch_info = ex_inst->getInstArchInfo();
+        const uint32_t width = arch_info->getEarlyOutWidth();
+        if ((early_out_bits_per_cycle_ == 0) || (width == 0) || !ex_inst->hasSourceValues())
+        {
+            return exe_time;
+        }
+
+        const uint64_t mask = (width == 64) ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+        auto significant_bits = [&](uint64_t value) -> uint32_t
+        {
+            value &= mask;
+            if (arch_info->isEarlyOutSigned() && ((value >> (width - 1)) & 1))
+            {
+                value = (~value + 1) & mask;
+            }
+            return (value == 0) ? 0 : 64 - __builtin_clzll(value);
+        };
+        const uint32_t dividend_bits = significant_bits(ex_inst->getSourceValue(0));
+        const uint32_t divisor_bits = significant_bits(ex_inst->getSourceValue(1));
+
+        // Divide by zero or a divisor larger than the dividend needs no
+        // iterations
+        const uint32_t quotient_bits = ((divisor_bits == 0) || (dividend_bits < divisor_bits))
+                                           ? 0
+                                           : dividend_bits - divisor_bits + 1;
+        const uint32_t early_time =
+            early_out_overhead_
+            + (quotient_bits + early_out_bits_per_cycle_ - 1) / early_out_bits_per_cycle_;
+        const uint32_t time = std::max(1u, std::min(early_time, exe_time));
+        early_out_cycles_saved_ += exe_time - time;
+        return time;
+    }
+
+    void ExecutePipe::releaseEngine_(const InstPtr & ex_inst)
+    {
+        const auto engine = std::find(engines_.begin(), engines_.end(), ex_inst);
+        if (engine != engines_.end())
+        {
+            engine->reset();
+        }
+    }
+
+    void ExecutePipe::setBusyUntil_(const sparta::Clock::Cycle busy_until)
+    {
+        busy_until_ = busy_until;
+        if (arbiter_ != nullptr)
+        {
+            arbiter_->setBusyUntil(getPipeNumber(), busy_until_, getClock()->currentCycle());
+        }
+    }
+
+    void ExecutePipe::unitFree_()
+    {
+        ILOG("Unit free for the next instruction");
+        out_execute_pipe_.send(1);
+    }
+
     // Called by the scheduler, scheduled by complete_inst_.
     void ExecutePipe::executeInst_(const InstPtr & ex_inst)
     {
-        ILOG("Executed inst: " << ex_inst);
+        // Flushed since it was inserted, its result is never written
+        if (ex_inst->isSquashed())
+        {
+            ILOG("Dropping squashed inst: " << ex_inst);
+            releaseEngine_(ex_inst);
+            return;
+        }
+
         auto reg_file = ex_inst->getRenameData().getDestination().rf;
         if (reg_file != core_types::RegFile::RF_INVALID)
         {
             const auto & dest_bits = ex_inst->getDestRegisterBitMask(reg_file);
-            scoreboard_views_[reg_file]->setReady(dest_bits);
+            if ((rf_ports_ != nullptr)
+                && !rf_ports_->reserveWrite(reg_file, getClock()->currentCycle()))
+            {
+                ILOG("No register file write port for " << ex_inst);
+                ++rf_write_port_conflicts_;
+                execute_inst_.preparePayload(ex_inst)->schedule(1);
+                return;
+            }
+            if (bypass_ != nullptr)
+            {
+                bypass_->recordResult(reg_file, dest_bits, getPipeNumber(),
+                                      getClock()->currentCycle());
+            }
+            if (ex_inst->isSpecIssued())
+            {
+                // Consumers wait until the loads it was woken by hit
+                ex_inst->setDestReadyHeld(true);
+            }
+            else
+            {
+                scoreboard_views_[reg_file]->setReady(dest_bits);
+            }
         }
+        ILOG("Executed inst: " << ex_inst);
+        releaseEngine_(ex_inst);
 
         if (enable_random_misprediction_)
         {
@@ -87,8 +206,17 @@ namespace olympia
             }
         }
 
-        // We're not busy anymore
-        unit_busy_ = false;
+        // The branch is resolved, flush the younger instructions now
+        // rather than when it reaches the head of the ROB
+        if (resolve_branches_at_execute_ && ex_inst->isMispredicted()
+            && !ex_inst->isResolvedAtExecute())
+        {
+            ILOG("Flushing younger instructions of mispredicted branch: " << ex_inst);
+            ex_inst->setResolvedAtExecute();
+            out_execute_flush_.send(
+                FlushManager::FlushingCriteria(FlushManager::FlushCause::MISPREDICTION, ex_inst));
+            ++num_branch_flushes_;
+        }
 
         // Count the instruction as completely executed
         ++total_insts_executed_;
@@ -100,25 +228,45 @@ namespace olympia
     // Called by the scheduler, scheduled by complete_inst_.
     void ExecutePipe::completeInst_(const InstPtr & ex_inst)
     {
+        if (ex_inst->isSquashed())
+        {
+            ILOG("Dropping squashed inst: " << ex_inst);
+            return;
+        }
         ex_inst->setStatus(Inst::Status::COMPLETED);
         complete_event_.collect(*ex_inst);
         ILOG("Completing inst: " << ex_inst);
         out_execute_pipe_.send(1);
     }
 
+    void ExecutePipe::cancelInst(const InstPtr & ex_inst)
+    {
+        ILOG("Cancel inst: " << ex_inst);
+        auto cancel = [&ex_inst](const InstPtr & inst) -> bool { return inst == ex_inst; };
+        complete_inst_.cancelIf(cancel);
+        execute_inst_.cancelIf(cancel);
+        releaseEngine_(ex_inst);
+        if (!canAccept() && (busy_inst_ == ex_inst))
+        {
+            busy_inst_.reset();
+            setBusyUntil_(0);
+            collected_inst_.closeRecord();
+        }
+    }
+
     void ExecutePipe::flushInst_(const FlushManager::FlushingCriteria & criteria)
     {
         ILOG("Got flush for criteria: " << criteria);
-        // Cancel outstanding instructions awaiting completion and
-        // instructions on their way to issue
-        auto flush = [criteria](const InstPtr & inst) -> bool
-        { return criteria.includedInFlush(inst); };
         issue_inst_.cancel();
-        complete_inst_.cancelIf(flush);
-        execute_inst_.cancelIf(flush);
-        if (execute_inst_.getNumOutstandingEvents() == 0)
+
+        // Squashed instructions awaiting execution or completion, and
+        // their iterative engines, are dropped when next touched
+        // (Inst::isSquashed). Only a squashed instruction holding the
+        // pipe busy frees it now.
+        if ((busy_inst_ != nullptr) && criteria.includedInFlush(busy_inst_))
         {
-            unit_busy_ = false;
+            busy_inst_.reset();
+            setBusyUntil_(0);
             collected_inst_.closeRecord();
         }
     }
@@ -25,9 +25,15 @@
 #include "sparta/resources/Scoreboard.hpp"
 #include "sparta/pevents/PeventCollector.hpp"
 
+#include <algorithm>
+#include <vector>
+
 #include "CoreTypes.hpp"
 #include "FlushManager.hpp"
+#include "BypassNetwork.hpp"
+#include "IssueArbiter.hpp"
 #include "Inst.hpp"
+#include "RegisterFilePorts.hpp"
 
 namespace olympia
 {
@@ -48,8 +54,22 @@ namespace olympia
                       "Ignore the instruction's execute time, "
                       "use execute_time param instead")
             PARAMETER(uint32_t, execute_time, 1, "Time for execution")
+            PARAMETER(bool, enable_pipelining, true,
+                      "Accept a new instruction every initiation interval of the last one, "
+                      "otherwise once it executes")
+            PARAMETER(uint32_t, num_iterative_engines, 0,
+                      "Iterative engines running non-pipelined instructions (div, sqrt) while "
+                      "the pipe takes other instructions, 0 blocks the pipe instead")
+            PARAMETER(uint32_t, early_out_bits_per_cycle, 0,
+                      "Quotient bits an early-out instruction retires per cycle, its latency "
+                      "follows the operand values. 0 uses the full latency")
+            PARAMETER(uint32_t, early_out_overhead, 2,
+                      "Fixed cycles of an early-out instruction, on top of its iterations")
             PARAMETER(bool, enable_random_misprediction, false,
                       "test mode to inject random branch mispredictions")
+            PARAMETER(bool, resolve_branches_at_execute, true,
+                      "Flush the instructions younger than a mispredicted branch when it "
+                      "executes, otherwise when it retires")
             HIDDEN_PARAMETER(bool, contains_branch_unit, false,
                              "Does this exe pipe contain a branch unit")
             HIDDEN_PARAMETER(std::string, iq_name, "", "issue queue name for scoreboard view")
@@ -66,15 +86,41 @@ namespace olympia
         //! \brief Name of this resource. Required by sparta::UnitFactory
         static const char name[];
 
-        bool canAccept() { return !unit_busy_; }
+        bool canAccept() { return getClock()->currentCycle() >= busy_until_; }
+
+        // A non-pipelined instruction can start, always true without
+        // iterative engines (the whole pipe is busy instead)
+        bool hasFreeEngine() const
+        {
+            return engines_.empty()
+                   || (std::find_if(engines_.begin(), engines_.end(), isEngineFree_)
+                       != engines_.end());
+        }
 
         // Write result to registers
         void insertInst(const InstPtr &);
 
+        // Cancel an instruction issued on a speculative load wakeup, the
+        // issue queue replays it
+        void cancelInst(const InstPtr &);
+
         // Used to set enable_random_misprediction_ for an execution pipe
         // set from Execute.cpp
         void setBranchRandomMisprediction(bool is_branch);
 
+        // Register file write ports arbitrated at writeback, unlimited if
+        // not set
+        void setRegisterFilePorts(RegisterFilePorts* rf_ports) { rf_ports_ = rf_ports; }
+
+        // Bypass network the results are forwarded on
+        void setBypassNetwork(BypassNetwork* bypass) { bypass_ = bypass; }
+
+        // Arbiter told when the pipe can take its next instruction
+        void setIssueArbiter(IssueArbiter* arbiter) { arbiter_ = arbiter; }
+
+        // Pipe number in the core's pipelines topology
+        uint32_t getPipeNumber() const { return getContainer()->getGroupIdx(); }
+
       private:
         // Ports and the set -- remove the ", 1" to experience a DAG issue!
         sparta::DataInPort<InstQueue::value_type> in_execute_inst_{&unit_port_set_,
@@ -84,19 +130,35 @@ namespace olympia
         sparta::DataOutPort<uint32_t> out_execute_pipe_{&unit_port_set_, "out_execute_pipe"};
         sparta::DataInPort<FlushManager::FlushingCriteria> in_reorder_flush_{
             &unit_port_set_, "in_reorder_flush", sparta::SchedulingPhase::Flush, 1};
+        sparta::DataOutPort<FlushManager::FlushingCriteria> out_execute_flush_{
+            &unit_port_set_, "out_execute_flush"};
 
         // Scoreboards
         using ScoreboardViews =
             std::array<std::unique_ptr<sparta::ScoreboardView>, core_types::N_REGFILES>;
         ScoreboardViews scoreboard_views_;
 
-        // Busy signal for the attached alu
-        bool unit_busy_ = false;
+        // Cycle the attached alu can take the next instruction
+        sparta::Clock::Cycle busy_until_ = 0;
         // Execution unit's execution time
         const bool ignore_inst_execute_time_ = false;
         const uint32_t execute_time_;
+        const bool enable_pipelining_;
+        const uint32_t early_out_bits_per_cycle_;
+        const uint32_t early_out_overhead_;
         const bool enable_random_misprediction_;
+        const bool resolve_branches_at_execute_;
         const std::string issue_queue_name_;
+        RegisterFilePorts* rf_ports_ = nullptr;
+        BypassNetwork* bypass_ = nullptr;
+        IssueArbiter* arbiter_ = nullptr;
+
+        // Instruction running on each iterative engine, nullptr if free.
+        // An engine running a squashed instruction is free as well.
+        std::vector<InstPtr> engines_;
+
+        // Last instruction inserted, it set busy_until_
+        InstPtr busy_inst_;
 
         // Events used to issue, execute and complete the instruction
         sparta::UniqueEvent<> issue_inst_{
@@ -105,6 +167,8 @@ namespace olympia
         sparta::PayloadEvent<InstPtr> execute_inst_{
             &unit_event_set_, getName() + "_execute_inst",
             CREATE_SPARTA_HANDLER_WITH_DATA(ExecutePipe, executeInst_, InstPtr)};
+        sparta::UniqueEvent<> unit_free_{&unit_event_set_, getName() + "_unit_free",
+                                         CREATE_SPARTA_HANDLER(ExecutePipe, unitFree_)};
         sparta::PayloadEvent<InstPtr> complete_inst_{
             &unit_event_set_, getName() + "_complete_inst",
             CREATE_SPARTA_HANDLER_WITH_DATA(ExecutePipe, completeInst_, InstPtr)};
@@ -120,10 +184,41 @@ namespace olympia
         sparta::Counter total_insts_executed_{getStatisticSet(), "total_insts_executed",
                                               "Total instructions executed",
                                               sparta::Counter::COUNT_NORMAL};
+        sparta::Counter num_branch_flushes_{getStatisticSet(), "num_branch_flushes",
+                                            "Mispredicted branches flushed at execute",
+                                            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter iterative_insts_{getStatisticSet(), "iterative_insts",
+                                         "Instructions run on an iterative engine",
+                                         sparta::Counter::COUNT_NORMAL};
+        sparta::Counter early_out_cycles_saved_{
+            getStatisticSet(), "early_out_cycles_saved",
+            "Cycles early-out instructions finished before their full latency",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter rf_write_port_conflicts_{
+            getStatisticSet(), "rf_write_port_conflicts",
+            "Writebacks delayed a cycle for a register file write port",
+            sparta::Counter::COUNT_NORMAL};
 
         void setupExecutePipe_();
         void executeInst_(const InstPtr &);
 
+        // Latency of an early-out instruction from its operand values
+        uint32_t earlyOutTime_(const InstPtr &, const uint32_t exe_time);
+
+        static bool isEngineFree_(const InstPtr & engine)
+        {
+            return (engine == nullptr) || engine->isSquashed();
+        }
+
+        // Free the iterative engine running the instruction, if any
+        void releaseEngine_(const InstPtr &);
+
+        // Set busy_until_, and the arbiter's pipe readiness
+        void setBusyUntil_(const sparta::Clock::Cycle busy_until);
+
+        // A pipelined unit can take the next instruction
+        void unitFree_();
+
         // Callback from Scoreboard to inform Operand Readiness
         // void handleOperandIssueCheck_(const InstPtr &);
         // Used to complete the inst in the FPU
@@ -6,6 +6,7 @@
 //!
 
 #include <algorithm>
+#include "CoreUtils.hpp"
 #include "Fetch.hpp"
 #include "InstGenerator.hpp"
 #include "MavisUnit.hpp"
@@ -22,14 +23,32 @@ namespace olympia
         sparta::Unit(node),
         num_insts_to_fetch_(p->num_to_fetch),
         skip_nonuser_mode_(p->skip_nonuser_mode),
-        my_clk_(getClock())
+        my_clk_(getClock()),
+        thread_workloads_(p->thread_workloads),
+        num_threads_(olympia::coreutils::getNumThreads(node->getParent())),
+        in_flight_insts_(num_threads_),
+        flush_epochs_(num_threads_)
     {
+        sparta_assert(num_threads_ > 0, "A core needs at least one hardware thread");
+        sparta_assert(thread_workloads_.empty() || (thread_workloads_.size() == num_threads_),
+                      "thread_workloads has " << thread_workloads_.size() << " workloads for "
+                      << num_threads_ << " hardware threads");
+        for(uint32_t thread_id = 0; thread_id < num_threads_; ++thread_id) {
+            thread_fetched_insts_.emplace_back(new sparta::Counter(
+                &unit_stat_set_, "fetched_insts_thread" + std::to_string(thread_id),
+                "Instructions fetched for hardware thread " + std::to_string(thread_id),
+                sparta::Counter::COUNT_NORMAL));
+        }
+
         in_fetch_queue_credits_.
             registerConsumerHandler(CREATE_SPARTA_HANDLER_WITH_DATA(Fetch, receiveFetchQueueCredits_, uint32_t));
 
         in_fetch_flush_redirect_.
             registerConsumerHandler(CREATE_SPARTA_HANDLER_WITH_DATA(Fetch, flushFetch_, FlushManager::FlushingCriteria));
 
+        in_rob_retire_ack_.
+            registerConsumerHandler(CREATE_SPARTA_HANDLER_WITH_DATA(Fetch, retireAck_, InstPtr));
+
         fetch_inst_event_.reset(new sparta::SingleCycleUniqueEvent<>(&unit_event_set_, "fetch_random",
                                                                      CREATE_SPARTA_HANDLER(Fetch, fetchInstruction_)));
         // Schedule a single event to start reading from a trace file
@@ -45,9 +64,14 @@ namespace olympia
         auto cpu_node   = getContainer()->getParent()->getParent();
         auto extension  = sparta::notNull(cpu_node->getExtension("simulation_configuration"));
         auto workload   = extension->getParameters()->getParameter("workload");
-        inst_generator_ = InstGenerator::createGenerator(getMavis(getContainer()),
-                                                         workload->getValueAsString(),
-                                                         skip_nonuser_mode_);
+        for(uint32_t thread_id = 0; thread_id < num_threads_; ++thread_id)
+        {
+            const std::string thread_workload = thread_workloads_.empty() ?
+                workload->getValueAsString() : thread_workloads_[thread_id];
+            inst_generators_.emplace_back(InstGenerator::createGenerator(getMavis(getContainer()),
+                                                                         thread_workload,
+                                                                         skip_nonuser_mode_));
+        }
 
         fetch_inst_event_->schedule(1);
     }
@@ -59,14 +83,25 @@ namespace olympia
         // Nothing to send.  Don't need to schedule this again.
         if(upper == 0) { return; }
 
+        // A fetch group holds instructions of one hardware thread
+        const uint32_t thread_id = selectThread_();
+        if(thread_id == num_threads_) { return; }
+        auto & inst_generator = inst_generators_[thread_id];
+
         InstGroupPtr insts_to_send = sparta::allocate_sparta_shared_pointer<InstGroup>(instgroup_allocator);
         for(uint32_t i = 0; i < upper; ++i)
         {
-            InstPtr ex_inst = inst_generator_->getNextInst(my_clk_);
+            InstPtr ex_inst = inst_generator->getNextInst(my_clk_);
             if(SPARTA_EXPECT_TRUE(nullptr != ex_inst))
             {
+                ex_inst->setUniqueID(++next_unique_id_);
+                ex_inst->setThreadID(thread_id);
+                ex_inst->setFlushGeneration(flush_epochs_[thread_id].getGeneration());
                 ex_inst->setSpeculative(speculative_path_);
                 insts_to_send->emplace_back(ex_inst);
+                if(num_threads_ > 1) {
+                    in_flight_insts_[thread_id].emplace_back(ex_inst);
+                }
 
                 ILOG("Sending: " << ex_inst << " down the pipe");
             }
@@ -80,8 +115,9 @@ namespace olympia
             out_fetch_queue_write_.send(insts_to_send);
 
             credits_inst_queue_ -= static_cast<uint32_t> (insts_to_send->size());
+            *thread_fetched_insts_[thread_id] += insts_to_send->size();
 
-            if((credits_inst_queue_ > 0) && (false == inst_generator_->isDone())) {
+            if((credits_inst_queue_ > 0) && (false == threadsDone_())) {
                 fetch_inst_event_->schedule(1);
             }
 
@@ -113,21 +149,66 @@ namespace olympia
 
         auto flush_inst = criteria.getInstPtr();
 
-        // Rewind the tracefile
+        // Rewind the tracefile of the flushed thread
+        const uint32_t thread_id = flush_inst->getThreadID();
         if (criteria.isInclusiveFlush())
         {
-            inst_generator_->reset(flush_inst, false); // Replay this instruction
+            inst_generators_[thread_id]->reset(flush_inst, false); // Replay this instruction
         }
         else
         {
-            inst_generator_->reset(flush_inst, true); // Skip to next instruction
+            inst_generators_[thread_id]->reset(flush_inst, true); // Skip to next instruction
         }
 
-        // Cancel all previously sent instructions on the outport
-        out_fetch_queue_write_.cancel();
+        // Cancel all previously sent instructions of the thread on the
+        // outport, a fetch group holds one thread
+        out_fetch_queue_write_.cancelIf([thread_id](const InstGroupPtr & insts) -> bool {
+            return (*insts->begin())->getThreadID() == thread_id;
+        });
+
+        // Instructions already sent are squashed from now on
+        flush_epochs_[thread_id].flush(criteria.isInclusiveFlush() ?
+                                       flush_inst->getUniqueID() : flush_inst->getUniqueID() + 1);
+
+        auto & in_flight = in_flight_insts_[thread_id];
+        while(!in_flight.empty() && criteria.includedInFlush(in_flight.back())) {
+            in_flight.pop_back();
+        }
 
         // No longer speculative
         // speculative_path_ = false;
     }
 
+    // Called from the ROB as instructions retire. Fused away
+    // instructions never retire, they leave with the next one.
+    void Fetch::retireAck_(const InstPtr & inst)
+    {
+        auto & in_flight = in_flight_insts_[inst->getThreadID()];
+        while(!in_flight.empty() && (in_flight.front()->getUniqueID() <= inst->getUniqueID())) {
+            in_flight.pop_front();
+        }
+    }
+
+    uint32_t Fetch::selectThread_() const
+    {
+        uint32_t selected = num_threads_;
+        for(uint32_t thread_id = 0; thread_id < num_threads_; ++thread_id)
+        {
+            if(inst_generators_[thread_id]->isDone()) {
+                continue;
+            }
+            if((selected == num_threads_) ||
+               (in_flight_insts_[thread_id].size() < in_flight_insts_[selected].size())) {
+                selected = thread_id;
+            }
+        }
+        return selected;
+    }
+
+    bool Fetch::threadsDone_() const
+    {
+        return std::all_of(inst_generators_.begin(), inst_generators_.end(),
+                           [](const auto & inst_generator) { return inst_generator->isDone(); });
+    }
+
 }
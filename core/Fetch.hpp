@@ -8,15 +8,19 @@
 
 #pragma once
 
+#include <deque>
 #include <string>
+#include <vector>
 #include "sparta/ports/DataPort.hpp"
 #include "sparta/events/SingleCycleUniqueEvent.hpp"
 #include "sparta/collection/Collectable.hpp"
 #include "sparta/simulation/Unit.hpp"
 #include "sparta/simulation/TreeNode.hpp"
 #include "sparta/simulation/ParameterSet.hpp"
+#include "sparta/statistics/Counter.hpp"
 
 #include "CoreTypes.hpp"
+#include "FlushEpoch.hpp"
 #include "InstGroup.hpp"
 #include "FlushManager.hpp"
 
@@ -56,6 +60,9 @@ namespace olympia
 
             PARAMETER(uint32_t, num_to_fetch,          4, "Number of instructions to fetch")
             PARAMETER(bool,     skip_nonuser_mode, false, "For STF traces, skip system instructions if present")
+            PARAMETER(std::vector<std::string>, thread_workloads, std::vector<std::string>(),
+                      "Workload of each hardware thread (SMT). Empty runs the simulation "
+                      "workload on every thread")
         };
 
         /**
@@ -88,6 +95,10 @@ namespace olympia
         sparta::DataInPort<FlushManager::FlushingCriteria> in_fetch_flush_redirect_
             {&unit_port_set_, "in_fetch_flush_redirect", sparta::SchedulingPhase::Flush, 1};
 
+        // Retired instructions, for the SMT thread selection
+        sparta::DataInPort<InstPtr> in_rob_retire_ack_
+            {&unit_port_set_, "in_rob_retire_ack", 1};
+
         ////////////////////////////////////////////////////////////////////////////////
         // Instruction fetch
         // Number of instructions to fetch
@@ -102,8 +113,27 @@ namespace olympia
         // Unit's clock
         const sparta::Clock * my_clk_ = nullptr;
 
-        // Instruction generation
-        std::unique_ptr<InstGenerator> inst_generator_;
+        // Workload of each hardware thread, empty for the simulation workload
+        const std::vector<std::string> thread_workloads_;
+
+        // Number of hardware threads, from the core extensions
+        const uint32_t num_threads_;
+
+        // Instruction generation, one per hardware thread
+        std::vector<std::unique_ptr<InstGenerator>> inst_generators_;
+
+        // Unique IDs are handed out in fetch order across the threads
+        uint64_t next_unique_id_ = 0;
+
+        // Instructions fetched and not yet retired or flushed, per
+        // thread. ICOUNT fetches the thread with the fewest
+        std::vector<std::deque<InstPtr>> in_flight_insts_;
+
+        // Instructions fetched per thread
+        std::vector<std::unique_ptr<sparta::Counter>> thread_fetched_insts_;
+
+        // Flush history of each thread, instructions are tagged with it
+        std::vector<FlushEpoch> flush_epochs_;
 
         // Fetch instruction event, triggered when there are credits
         // from decode.  The callback set is either to fetch random
@@ -125,8 +155,21 @@ namespace olympia
         // Receive flush from FlushManager
         void flushFetch_(const FlushManager::FlushingCriteria &);
 
+        // Receive retired instructions from the ROB
+        void retireAck_(const InstPtr &);
+
+        // ICOUNT thread selection: the thread with work left and the
+        // fewest instructions in flight, num_threads_ if none
+        uint32_t selectThread_() const;
+
+        // Does any thread have instructions left to fetch?
+        bool threadsDone_() const;
+
         // Are we fetching a speculative path?
         bool speculative_path_ = false;
+
+        friend class FetchTester;
     };
 
+    class FetchTester;
 }
@@ -0,0 +1,96 @@
+// <FlushEpoch.hpp> -*- C++ -*-
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+
+namespace olympia
+{
+    /**
+     * \class FlushEpoch
+     * \brief Flush history of a hardware thread, for lazy flushing
+     *
+     * Fetch tags each instruction with the thread's current generation,
+     * every flush starts a new one.  An instruction is squashed if a
+     * flush after its generation starts at or before its unique ID.
+     *
+     * A generation is shared by its instructions and lives as long as
+     * one of them does.  The epoch only keeps the live generations, so
+     * a flush updates the generations that still have instructions in
+     * flight and the history does not grow with the number of flushes.
+     * Checking an instruction is a compare against its generation's
+     * boundary; structures that hold squashed work without credits
+     * (the LSU ready queue and replay events) drop it when they next
+     * touch it instead of searching their contents on the flush.
+     */
+    class FlushEpoch
+    {
+    public:
+        class Generation
+        {
+        public:
+            bool isSquashed(const uint64_t unique_id) const { return unique_id >= squash_from_; }
+
+        private:
+            friend class FlushEpoch;
+
+            // Lowest unique ID squashed by the flushes after this
+            // generation
+            uint64_t squash_from_ = std::numeric_limits<uint64_t>::max();
+        };
+
+        using GenerationPtr = std::shared_ptr<const Generation>;
+
+        FlushEpoch() { newGeneration_(); }
+
+        //! Generation of the instructions fetched now
+        GenerationPtr getGeneration() const { return current_; }
+
+        //! Record a flush of the instructions fetched so far with a
+        //! unique ID of first_squashed or younger
+        void flush(const uint64_t first_squashed)
+        {
+            // Older generations saw every later flush, their boundary
+            // is the lowest of them. Boundaries do not decrease with
+            // the generation.
+            for (auto it = generations_.rbegin(); it != generations_.rend(); ++it)
+            {
+                const auto generation = it->lock();
+                if (generation == nullptr)
+                {
+                    continue;
+                }
+                if (generation->squash_from_ <= first_squashed)
+                {
+                    break;
+                }
+                generation->squash_from_ = first_squashed;
+            }
+            newGeneration_();
+        }
+
+        //! Number of generations kept, from the oldest one in flight
+        uint32_t getNumGenerations() const { return generations_.size(); }
+
+    private:
+        void newGeneration_()
+        {
+            current_ = std::make_shared<Generation>();
+
+            // Retire the generations whose instructions are all gone
+            while (!generations_.empty() && generations_.front().expired())
+            {
+                generations_.pop_front();
+            }
+            generations_.emplace_back(current_);
+        }
+
+        std::shared_ptr<Generation> current_;
+
+        // Oldest first
+        std::deque<std::weak_ptr<Generation>> generations_;
+    };
+}
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <cinttypes>
+#include <map>
 #include <string>
 
 #include "sparta/simulation/Unit.hpp"
@@ -88,9 +89,14 @@ namespace olympia
             const InstPtr & getInstPtr() const { return inst_ptr_; }
             bool isInclusiveFlush() const { return is_inclusive_; }
             bool isLowerPipeFlush() const { return cause_ == FlushCause::MISFETCH; }
+            uint32_t getThreadID() const  { return inst_ptr_->getThreadID(); }
 
+            // A flush only squashes instructions of its own hardware thread
             bool includedInFlush(const InstPtr& other) const
             {
+                if (inst_ptr_->getThreadID() != other->getThreadID()) {
+                    return false;
+                }
                 return isInclusiveFlush() ?
                     inst_ptr_->getUniqueID() <= other->getUniqueID() :
                     inst_ptr_->getUniqueID() < other->getUniqueID();
@@ -146,41 +152,51 @@ namespace olympia
                                         "flush_event",
                                          CREATE_SPARTA_HANDLER(FlushManager, forwardFlush_)};
 
-        // Hold oldest incoming flush request for forwarding
-        sparta::utils::ValidValue<FlushingCriteria> pending_flush_;
+        // Hold oldest incoming flush request of each hardware thread for
+        // forwarding
+        std::map<uint32_t, FlushingCriteria> pending_flushes_;
 
         // Arbitrates and forwards the flush request from the input flush ports, to the output ports
         void forwardFlush_()
         {
-            sparta_assert(pending_flush_.isValid(), "no flush to forward onwards?");
-            auto flush_data = pending_flush_.getValue();
-            if (flush_data.isLowerPipeFlush())
-            {
-                ILOG("instigating lower pipeline flush for: " << flush_data);
-                out_flush_lower_.send(flush_data);
-            }
-            else
+            sparta_assert(!pending_flushes_.empty(), "no flush to forward onwards?");
+            for (const auto & [thread_id, flush_data] : pending_flushes_)
             {
-                ILOG("instigating upper pipeline flush for: " << flush_data);
-                out_flush_upper_.send(flush_data);
+                if (flush_data.isLowerPipeFlush())
+                {
+                    ILOG("instigating lower pipeline flush for: " << flush_data);
+                    out_flush_lower_.send(flush_data);
+                }
+                else
+                {
+                    ILOG("instigating upper pipeline flush for: " << flush_data);
+                    out_flush_upper_.send(flush_data);
+                }
             }
-            pending_flush_.clearValid();
+            pending_flushes_.clear();
         }
 
         void receiveFlush_(const FlushingCriteria & flush_data)
         {
+            // A branch resolved out of order may have been squashed by
+            // an older flush already
+            if (flush_data.getInstPtr()->getFlushedStatus() || flush_data.getInstPtr()->isSquashed())
+            {
+                ILOG("dropping flush of a flushed instruction: " << flush_data);
+                return;
+            }
             ev_flush_.schedule();
 
-            // Capture the oldest flush request only
-            if (pending_flush_.isValid())
+            // Capture the oldest flush request of the thread only
+            const uint32_t thread_id = flush_data.getThreadID();
+            if (auto pending = pending_flushes_.find(thread_id); pending != pending_flushes_.end())
             {
-                auto pending = pending_flush_.getValue();
-                if (pending.includedInFlush(flush_data.getInstPtr()))
+                if (pending->second.includedInFlush(flush_data.getInstPtr()))
                 {
                     return;
                 }
             }
-            pending_flush_ = flush_data;
+            pending_flushes_[thread_id] = flush_data;
         }
 
     };
@@ -1,7 +1,11 @@
 // TODO: add Condor header - this is a new file
 // contact jeff at condor
 #include "fusion/FusionTypes.hpp"
+#include "fusion/FusionMatch.hpp"
 #include "Decode.hpp"
+#ifdef OLYMPIA_STATIC_FUSION_TABLES
+#include "FusionGroupTables.hpp"
+#endif
 
 #include "sparta/events/StartupEvent.hpp"
 #include "sparta/utils/LogUtils.hpp"
@@ -93,6 +97,13 @@ namespace olympia
                     ++fusion_num_ghost_instructions_;
                     ++fusion_pred_cycles_saved_;
                 }
+                // Group includes instructions held back by the fusion window
+                const size_t start_idx = static_cast<size_t>(thisMatch.startIdx);
+                if ((start_idx < num_held_insts_)
+                    && (start_idx + thisMatch.size() > num_held_insts_))
+                {
+                    ++fusion_num_window_fusions_;
+                }
                 updateFusionGroupUtilization_(thisMatch.name);
             }
         }
@@ -101,104 +112,90 @@ namespace olympia
     }
 
     // ----------------------------------------------------------------------
-    // TODO: this performs well for the FusionGroup set sizes tested, ~256.
-    // More testing is intended for 2048 (10x any practical size).
-    // Further improvement is deferred until a decsion on uop/trace cache
-    // implementations. Regardless, if warranted for model performance,
-    // an abstracted uop$ can be built using what is below adding the more
-    // conventional address indexing but retaining the UIDs as abstractions
-    // to fully decoded instrs.
+    // The matcher lives in the fusion library so it can be benchmarked
+    // outside of the model, see fusion/bench.
     // ----------------------------------------------------------------------
     void Decode::matchFusionGroups_(MatchInfoListType & matches, InstGroupPtr & insts,
                                     InstUidListType & inputUids,
                                     FusionGroupContainerType & fusionGroups)
     {
-        matches.clear(); // Clear any existing matches
-
-        // The cache is a map of cachelines, indexed by size,
-        //          <size, list of <index,hash>
-        //
-        //   3   1:hash  2:hash 3:hash  ... modulo size, inputUids.size() % 3
-        hcache_.clear();
+        fusion::matchGroups(matches, inputUids, fusionGroups, hcache_);
+    }
 
-        for (auto & fgPair : fusionGroups)
-        {
-            auto & fGrp = fgPair.second;
-            size_t grpSize = fGrp.uids().size();
-            hcache_.buildHashCacheEntry(inputUids, grpSize);
-        }
+    // ------------------------------------------------------------------------
+    // Lookup each input segment in the generated perfect hash index.
+    // ------------------------------------------------------------------------
+    void Decode::matchStaticFusionGroups_(MatchInfoListType & matches,
+                                          const InstUidListType & inputUids)
+    {
+        matches.clear();
 
-        for (auto & fgPair : fusionGroups)
+#ifdef OLYMPIA_STATIC_FUSION_TABLES
+        const auto & table = fusion::generated::fusion_groups;
+        const size_t maxSize = table.maxGroupSize();
+        for (size_t startIdx = 0; startIdx < inputUids.size(); ++startIdx)
         {
-
-            HashType grpHash = fgPair.first;
-            auto & fGrp = fgPair.second;
-            size_t grpSize = fGrp.uids().size();
-
-            // No match possible if the fg is bigger than the input
-            if (grpSize > inputUids.size())
-            {
-                /*++filtered;*/ continue;
-            }
-
-            // If the grpSize is not in the hash cache we need to calculate it
-            if (hcache_.find(grpSize) == hcache_.end())
+            // Extend the hash of the window one uid at a time, each
+            // group size starting here is hashed once
+            fusion::HashType partial = 0;
+            const size_t endIdx = std::min(inputUids.size(), startIdx + maxSize);
+            for (size_t idx = startIdx; idx < endIdx; ++idx)
             {
-                hcache_.buildHashCacheEntry(inputUids, grpSize);
+                partial = FusionGroupType::jenkins_1aat_step(partial, inputUids[idx]);
+                const size_t grpSize = idx - startIdx + 1;
+                const auto* grp = table.find(FusionGroupType::jenkins_1aat_final(partial));
+                if (grp != nullptr && grp->uidCount == grpSize
+                    && table.matches(*grp, inputUids, startIdx))
+                {
+                    matches.emplace_back(grp->name, startIdx, 0, table.uidList(*grp));
+                }
             }
+        }
+#else
+        (void)inputUids;
+#endif
 
-            // If this fires something unexplained happened, the entry hit
-            // in the first place or it was constructed on a miss,
-            // either way this should never fire.
-            sparta_assert(hcache_.find(grpSize) != hcache_.end())
-
-                // pairs is from the cache entries with the same size as fGrp.
-                // a pair is <index,hash>, index is the position in the input
-                HashPairListType pairs = hcache_[grpSize];
+        // Same ordering as matchFusionGroups_
+        fusion::sortMatches(matches);
+    }
 
-            // For each of the pairs that have the same size as fGrp.
-            for (auto & ep : pairs)
+    // ------------------------------------------------------------------------
+    // Fusion group configs from the generated tables, no file parsing
+    // ------------------------------------------------------------------------
+    bool Decode::constructStaticFusionGroups_(FusionGroupCfgListType & cfgGroups)
+    {
+#ifdef OLYMPIA_STATIC_FUSION_TABLES
+        // The tables are fixed at build time, flag an arch that expects
+        // other groups
+        const std::string source = fusion::generated::SOURCE_JSON;
+        for (const auto & definition : fusion_group_definitions_)
+        {
+            const std::string name = definition.substr(definition.find_last_of('/') + 1);
+            if (name != source)
             {
-                // if the pair.hash matches the group's hash
-                if (ep.second == grpHash)
-                {
-
-                    // DLOG("HASH HIT, index "<<dec<<ep.first<<" hash 0x"<<setw(8)
-                    //                        <<hex<<setfill('0')<<grpHash);
-                    size_t startIdx = ep.first;
-                    bool match = true;
-                    size_t j = 0;
-
-                    for (size_t i = startIdx; i < grpSize; ++i)
-                    {
-                        if (inputUids[i] != fGrp.uids()[j])
-                        {
-                            match = false;
-                            break;
-                        }
-                        ++j;
-                    }
-
-                    if (match)
-                    {
-                        matches.emplace_back(fGrp.name(), startIdx, 0, fGrp.uids());
-                        // DLOG("SEQ MATCH "<<fGrp.name()<<" "<<dec<<grpSize);
-                    }
-                }
+                std::cerr << "WARNING: " << getContainer()->getLocation()
+                          << ": fusion_use_static_tables uses the groups of " << source
+                          << " from the build, fusion_group_definitions " << definition
+                          << " is ignored" << std::endl;
             }
         }
 
-        // FIXME: make this an assignable function object
-        // Sort by size descending, sort by startIdx ascending
-        std::sort(matches.begin(), matches.end(),
-                  [](const FusionGroupMatchInfo & lhs, const FusionGroupMatchInfo & rhs)
-                  {
-                      if (lhs.size() == rhs.size())
-                      {
-                          return lhs.startIdx < rhs.startIdx;
-                      }
-                      return lhs.size() > rhs.size();
-                  });
+        const auto & table = fusion::generated::fusion_groups;
+        for (uint32_t i = 0; i < table.size(); ++i)
+        {
+            FusionGroupCfgType fg{.name = table[i].name,
+                                  .uids = table.uidList(table[i]),
+                                  .transformName = table[i].transformName};
+            cfgGroups.push_back(std::move(fg));
+        }
+        return true;
+#else
+        (void)cfgGroups;
+        std::cerr << "WARNING: " << getContainer()->getLocation()
+                  << ": the build has no static fusion tables, fusion_group_definitions"
+                  << " is used instead" << std::endl;
+        return false;
+#endif
     }
 
     // ------------------------------------------------------------------------
@@ -1,6 +1,7 @@
 // <Inst.cpp> -*- C++ -*-
 
 #include "Inst.hpp"
+#include <algorithm>
 #include <unordered_map>
 
 namespace olympia
@@ -47,6 +48,37 @@ namespace olympia
         return false;
     }
 
+    bool hasVectorOperand(const mavis::OpcodeInfo::PtrType & opcode_info)
+    {
+        auto is_vector = [](const auto & op)
+        { return op.operand_type == mavis::InstMetaData::OperandTypes::VECTOR; };
+        const auto & srcs = opcode_info->getSourceOpInfoList();
+        const auto & dests = opcode_info->getDestOpInfoList();
+        return std::any_of(srcs.begin(), srcs.end(), is_vector)
+               || std::any_of(dests.begin(), dests.end(), is_vector);
+    }
+
+    // A CSR read with no side effects: csrrs/csrrc with rs1 = x0 or
+    // csrrsi/csrrci with a zero mask, of fflags, frm, fcsr or the
+    // read-only counters (cycle, time, instret, hpmcounters and their
+    // RV32 high halves)
+    bool isRenameableCsrRead(const mavis::OpcodeInfo::PtrType & opcode_info)
+    {
+        const uint32_t opcode = static_cast<uint32_t>(opcode_info->getOpcode());
+        constexpr uint32_t SYSTEM_OPCODE = 0x73;
+        const uint32_t funct3 = (opcode >> 12) & 0x7;
+        if (((opcode & 0x7f) != SYSTEM_OPCODE)
+            || !miscutils::isOneOf(funct3, 2u /* csrrs */, 3u /* csrrc */, 6u /* csrrsi */,
+                                   7u /* csrrci */)
+            || (((opcode >> 15) & 0x1f) != 0))
+        {
+            return false;
+        }
+        const uint32_t csr = opcode >> 20;
+        return ((csr >= 0x001) && (csr <= 0x003)) || ((csr >= 0xc00) && (csr <= 0xc1f))
+               || ((csr >= 0xc80) && (csr <= 0xc9f));
+    }
+
     /*!
      * \brief Construct an Instruction
      * \param opcode_info    Mavis Opcode information
@@ -64,14 +96,64 @@ namespace olympia
         is_transfer_(miscutils::isOneOf(inst_arch_info_->getTargetPipe(),
                                         InstArchInfo::TargetPipe::I2F,
                                         InstArchInfo::TargetPipe::F2I)),
+        is_vector_(hasVectorOperand(opcode_info)),
         is_branch_(opcode_info_->isInstType(mavis::OpcodeInfo::InstructionTypes::BRANCH)),
         is_condbranch_(opcode_info_->isInstType(mavis::OpcodeInfo::InstructionTypes::CONDITIONAL)),
         is_call_(isCallInstruction(opcode_info)),
         is_return_(isReturnInstruction(opcode_info)),
+        is_renameable_csr_read_(isRenameableCsrRead(opcode_info)),
         status_state_(Status::FETCHED)
     {
         sparta_assert(inst_arch_info_ != nullptr,
                       "Mavis decoded the instruction, but Olympia has no uarch data for it: "
                           << getDisasm() << " " << std::hex << " opc: 0x" << getOpCode());
     }
+
+    Inst::Inst(const Inst & parent, const InstArchInfo::PtrType & uop_info,
+               uint32_t uop_index) :
+        Inst(parent)
+    {
+        sparta_assert(parent.inst_arch_info_->getNumUops() > uop_index,
+                      "Micro-op " << uop_index << " out of range for " << parent);
+        inst_arch_info_ = uop_info;
+        uop_index_ = uop_index;
+        num_uops_ = parent.inst_arch_info_->getNumUops();
+        is_store_ = uop_info->isUopStore();
+
+        // Only the last micro-op moves the retire pointer
+        program_id_increment_ = (uop_index_ + 1 == num_uops_) ? parent.program_id_increment_ : 0;
+
+        // Pick the parent operands this micro-op uses.  A parent
+        // destination can be a source, this is how micro-ops of the
+        // same instruction depend on each other.
+        const auto & srcs = parent.opcode_info_->getSourceOpInfoList();
+        const auto & dests = parent.opcode_info_->getDestOpInfoList();
+        auto find_operand = [](const OpInfoList & ops,
+                               mavis::InstMetaData::OperandFieldID field_id)
+            -> const OpInfoList::value_type*
+        {
+            auto itr = std::find_if(ops.begin(), ops.end(),
+                                    [field_id](const auto & op) { return op.field_id == field_id; });
+            return (itr != ops.end()) ? &(*itr) : nullptr;
+        };
+        for (const auto field_id : uop_info->getUopSources())
+        {
+            const auto* op = find_operand(srcs, field_id);
+            if (op == nullptr)
+            {
+                op = find_operand(dests, field_id);
+            }
+            if (op != nullptr)
+            {
+                uop_srcs_.emplace_back(*op);
+            }
+        }
+        for (const auto field_id : uop_info->getUopDests())
+        {
+            if (const auto* op = find_operand(dests, field_id); op != nullptr)
+            {
+                uop_dests_.emplace_back(*op);
+            }
+        }
+    }
 } // namespace olympia
@@ -15,6 +15,7 @@
 
 #include "InstArchInfo.hpp"
 #include "CoreTypes.hpp"
+#include "FlushEpoch.hpp"
 #include "MiscUtils.hpp"
 
 #include <cstdlib>
@@ -115,6 +116,18 @@ namespace olympia
         // implement it and let the compiler do it for us for speed.
         Inst(const Inst & other) = default;
 
+        /*!
+         * \brief Construct a micro-op of a cracked instruction
+         * \param parent     The instruction being cracked
+         * \param uop_info   Static data of the micro-op (from parent's InstArchInfo)
+         * \param uop_index  Position of the micro-op in the parent
+         *
+         * The micro-op keeps the unique and program IDs of the
+         * parent. Only the last micro-op advances the program ID so
+         * the ROB retires all micro-ops of the parent together.
+         */
+        Inst(const Inst & parent, const InstArchInfo::PtrType & uop_info, uint32_t uop_index);
+
         void setStatus(Status status)
         {
             sparta_assert(status_state_ != status,
@@ -158,6 +171,18 @@ namespace olympia
             return is_mispredicted_;
         }
 
+        // The mispredicted branch flushed the younger instructions when
+        // it executed, the ROB does not flush again at retire
+        void setResolvedAtExecute()
+        {
+            is_resolved_at_execute_ = true;
+        }
+
+        bool isResolvedAtExecute() const
+        {
+            return is_resolved_at_execute_;
+        }
+
         const Status & getExtendedStatus() const
         {
           return extended_status_state_;
@@ -177,7 +202,11 @@ namespace olympia
 
         InstArchInfo::TargetPipe getPipe() const
         {
-            return inst_arch_info_->getTargetPipe(); }
+            return is_csr_renamed_ ? InstArchInfo::TargetPipe::CSR
+                                   : inst_arch_info_->getTargetPipe();
+        }
+
+        const InstArchInfo::PtrType & getInstArchInfo() const { return inst_arch_info_; }
 
         // ROB handling -- mark this instruction as the oldest in the machine
         void setOldest(bool oldest, sparta::Scheduleable* rob_retire_event)
@@ -188,6 +217,12 @@ namespace olympia
 
         bool isMarkedOldest() const { return is_oldest_; }
 
+        // Rename eliminated this move or zeroing idiom, it completes
+        // without being dispatched to an issue queue
+        void setEliminated(bool eliminated) { is_eliminated_ = eliminated; }
+
+        bool isEliminated() const { return is_eliminated_; }
+
         // Rewind iterator used for going back in program simulation after flushes
         template <typename T> void setRewindIterator(T iter) { rewind_iter_ = iter; }
 
@@ -208,6 +243,26 @@ namespace olympia
 
         uint64_t getProgramID() const { return program_id_; }
 
+        // Hardware thread (SMT) the instruction was fetched for. Unique
+        // IDs are in fetch order across the threads, program IDs are
+        // per thread
+        void setThreadID(uint32_t thread_id) { thread_id_ = thread_id; }
+
+        uint32_t getThreadID() const { return thread_id_; }
+
+        // Flush generation of the instruction's thread it was fetched in
+        void setFlushGeneration(const FlushEpoch::GenerationPtr & generation)
+        {
+            flush_generation_ = generation;
+        }
+
+        // Has a flush squashed this instruction? Structures that flush
+        // lazily drop squashed entries when they next touch them
+        bool isSquashed() const
+        {
+            return (flush_generation_ != nullptr) && flush_generation_->isSquashed(unique_id_);
+        }
+
         //A fused operation will modify the program_id_increment_ based on 
         //the number of instructions fused. A-B-C-D -> fA  incr becomes 4
         //This is planned, but not currently used. 
@@ -222,6 +277,34 @@ namespace olympia
             return program_id_increment_;
         }
 
+        // Micro-op cracking: position of this micro-op in its parent
+        // instruction and the parent's micro-op count (1 if not cracked)
+        uint32_t getUopIndex() const { return uop_index_; }
+
+        uint32_t getNumUops() const { return num_uops_; }
+
+        bool isCracked() const { return num_uops_ > 1; }
+
+        // Scoreboard callback key, micro-ops of a cracked instruction
+        // share its unique ID
+        uint64_t getCallbackID() const
+        {
+            sparta_assert(uop_index_ < 256, "Too many micro-ops for " << *this);
+            return (unique_id_ << 8) | uop_index_;
+        }
+
+        // Issued on a speculative load wakeup, the destination is not
+        // marked ready until the loads resolve (IssueQueue)
+        void setSpecIssued(bool spec_issued) { is_spec_issued_ = spec_issued; }
+
+        bool isSpecIssued() const { return is_spec_issued_; }
+
+        // Executed while speculatively issued, the destination ready
+        // bits are set by the issue queue when the loads hit
+        void setDestReadyHeld(bool held) { is_dest_ready_held_ = held; }
+
+        bool isDestReadyHeld() const { return is_dest_ready_held_; }
+
         // Set the instruction's PC
         void setPC(sparta::memory::addr_t inst_pc) { inst_pc_ = inst_pc; }
 
@@ -232,6 +315,22 @@ namespace olympia
 
         sparta::memory::addr_t getTargetVAddr() const { return target_vaddr_; }
 
+        // Vector load/store element accesses: vl elements of eew
+        // bytes starting at the target address, stride bytes apart
+        // (stride == eew for a unit-stride access)
+        void setVectorAccess(uint32_t vl, uint32_t eew, int64_t stride)
+        {
+            vector_vl_ = vl;
+            vector_eew_ = eew;
+            vector_stride_ = stride;
+        }
+
+        uint32_t getVectorLength() const { return vector_vl_; }
+
+        uint32_t getVectorElementWidth() const { return vector_eew_; }
+
+        int64_t getVectorStride() const { return vector_stride_; }
+
         // Branch instruction was taken (always set for JAL/JALR)
         void setTakenBranch(bool taken) { is_taken_branch_ = taken; }
 
@@ -249,15 +348,22 @@ namespace olympia
         mavis::InstructionUniqueID getMavisUid() const
                 { return opcode_info_->getInstructionUniqueID(); }
 
+        bool hasImmediate() const { return opcode_info_->hasImmediate(); }
+
+        uint64_t getImmediate() const { return opcode_info_->getImmediate(); }
+
         // Operand information
         using OpInfoList = mavis::DecodedInstructionInfo::OpInfoList;
 
         const OpInfoList & getSourceOpInfoList() const
         {
-            return opcode_info_->getSourceOpInfoList();
+            return isCracked() ? uop_srcs_ : opcode_info_->getSourceOpInfoList();
         }
 
-        const OpInfoList & getDestOpInfoList() const { return opcode_info_->getDestOpInfoList(); }
+        const OpInfoList & getDestOpInfoList() const
+        {
+            return isCracked() ? uop_dests_ : opcode_info_->getDestOpInfoList();
+        }
 
         // Static instruction information
         bool isStoreInst() const { return is_store_; }
@@ -266,12 +372,38 @@ namespace olympia
 
         uint32_t getExecuteTime() const { return inst_arch_info_->getExecutionTime(); }
 
-        uint64_t getRAdr() const { return target_vaddr_ | 0x8000000; } // faked
+        uint32_t getInitiationInterval() const
+        {
+            return inst_arch_info_->getInitiationInterval();
+        }
+
+        // Values of the first two source operands, from the trace, for
+        // the latency of early-out instructions
+        void setSourceValues(const uint64_t src1_value, const uint64_t src2_value)
+        {
+            src_values_ = {src1_value, src2_value};
+            has_src_values_ = true;
+        }
+
+        bool hasSourceValues() const { return has_src_values_; }
+
+        uint64_t getSourceValue(const uint32_t idx) const { return src_values_[idx]; }
+
+        uint64_t getRAdr() const { return getRAdrOf(target_vaddr_); }
+
+        // Real address of any virtual address of this instruction, as
+        // the cache lines of a vector access
+        static uint64_t getRAdrOf(const sparta::memory::addr_t vaddr)
+        {
+            return vaddr | 0x8000000; // faked
+        }
 
         bool isSpeculative() const { return is_speculative_; }
 
         bool isTransfer() const { return is_transfer_; }
 
+        bool isVector() const { return is_vector_; }
+
         bool isTakenBranch() const { return is_taken_branch_; }
 
         bool isBranch() const { return is_branch_; }
@@ -282,6 +414,25 @@ namespace olympia
 
         bool isReturn() const { return is_return_; }
 
+        // A read of the FP flags, rounding mode or a read-only counter
+        // that can be renamed instead of serializing the pipeline
+        bool isRenameableCsrRead() const { return is_renameable_csr_read_; }
+
+        // Execute the CSR read in the CSR pipe, with no flush at retire
+        void setCsrRenamed()
+        {
+            sparta_assert(is_renameable_csr_read_, "CSR access cannot be renamed: " << *this);
+            is_csr_renamed_ = true;
+        }
+
+        bool isCsrRenamed() const { return is_csr_renamed_; }
+
+        // Predicted on the critical path, issued ahead of older
+        // instructions
+        void setCritical(bool critical) { is_critical_ = critical; }
+
+        bool isCritical() const { return is_critical_; }
+
         // Rename information
         core_types::RegisterBitMask & getSrcRegisterBitMask(const core_types::RegFile rf)
         {
@@ -359,20 +510,39 @@ namespace olympia
         sparta::memory::addr_t inst_pc_ = 0; // Instruction's PC
         sparta::memory::addr_t target_vaddr_ =
             0; // Instruction's Target PC (for branches, loads/stores)
+        uint32_t vector_vl_ = 0;     // Vector load/store elements, 0 if not set
+        uint32_t vector_eew_ = 0;
+        int64_t vector_stride_ = 0;
         bool is_oldest_ = false;
+        bool is_eliminated_ = false;
         uint64_t unique_id_ = 0;      // Supplied by Fetch
         uint64_t program_id_ = 0;     // Supplied by a trace Reader or execution backend
         uint64_t program_id_increment_ = 1;
+        uint32_t thread_id_ = 0;      // Supplied by Fetch
+        FlushEpoch::GenerationPtr flush_generation_; // Supplied by Fetch
+        uint32_t uop_index_ = 0;
+        uint32_t num_uops_ = 1;
+        bool is_spec_issued_ = false;
+        bool is_dest_ready_held_ = false;
+        OpInfoList uop_srcs_;  // Operands of a micro-op, subsets of the parent's
+        OpInfoList uop_dests_;
         bool is_speculative_ = false; // Is this instruction soon to be flushed?
-        const bool is_store_;
+        bool is_store_;
         const bool is_transfer_; // Is this a transfer instruction (F2I/I2F)
+        const bool is_vector_;   // Has a vector register operand
         const bool is_branch_;
         const bool is_condbranch_;
         const bool is_call_;
         const bool is_return_;
+        const bool is_renameable_csr_read_;
+        bool is_csr_renamed_ = false;
+        bool is_critical_ = false;
 
         // Did this instruction mispredict?
         bool is_mispredicted_ = false;
+        bool is_resolved_at_execute_ = false;
+        std::array<uint64_t, 2> src_values_{};
+        bool has_src_values_ = false;
         bool is_taken_branch_ = false;
         sparta::Scheduleable* ev_retire_ = nullptr;
         Status status_state_;
@@ -11,7 +11,15 @@ namespace olympia
         {"float", InstArchInfo::TargetPipe::FLOAT}, {"fmac", InstArchInfo::TargetPipe::FMAC},
         {"i2f", InstArchInfo::TargetPipe::I2F},     {"f2i", InstArchInfo::TargetPipe::F2I},
         {"int", InstArchInfo::TargetPipe::INT},     {"lsu", InstArchInfo::TargetPipe::LSU},
-        {"mul", InstArchInfo::TargetPipe::MUL},     {"sys", InstArchInfo::TargetPipe::SYS}};
+        {"mul", InstArchInfo::TargetPipe::MUL},     {"vint", InstArchInfo::TargetPipe::VINT},
+        {"vmul", InstArchInfo::TargetPipe::VMUL},   {"vdiv", InstArchInfo::TargetPipe::VDIV},
+        {"csr", InstArchInfo::TargetPipe::CSR},     {"sys", InstArchInfo::TargetPipe::SYS}};
+
+    const InstArchInfo::OperandFieldMap InstArchInfo::uop_operand_map = {
+        {"rs1", mavis::InstMetaData::OperandFieldID::RS1},
+        {"rs2", mavis::InstMetaData::OperandFieldID::RS2},
+        {"rs3", mavis::InstMetaData::OperandFieldID::RS3},
+        {"rd", mavis::InstMetaData::OperandFieldID::RD}};
 
     void InstArchInfo::update(const nlohmann::json & jobj)
     {
@@ -34,7 +42,70 @@ namespace olympia
         sparta_assert(execute_time_ != 0, "Unknown execution time (latency) for "
                                               << jobj["mnemonic"].get<std::string>());
 
+        if (jobj.find("pipelined") != jobj.end())
+        {
+            is_pipelined_ = jobj["pipelined"].get<bool>();
+        }
+        if (jobj.find("initiation_interval") != jobj.end())
+        {
+            initiation_interval_ = jobj["initiation_interval"].get<uint32_t>();
+        }
+        sparta_assert(initiation_interval_ != 0, "Initiation interval of 0 for "
+                                                     << jobj["mnemonic"].get<std::string>());
+
+        if (jobj.find("early_out") != jobj.end())
+        {
+            const auto & jearly_out = jobj["early_out"];
+            early_out_width_ = jearly_out["width"].get<uint32_t>();
+            early_out_signed_ = jearly_out["signed"].get<bool>();
+            sparta_assert((early_out_width_ > 0) && (early_out_width_ <= 64),
+                          "Early-out width must be 1 to 64 for "
+                              << jobj["mnemonic"].get<std::string>());
+        }
+
         is_load_store_ = (tgt_pipe_ == TargetPipe::LSU);
+
+        // Micro-op operands, only meaningful in a "uops" entry
+        parseUopOperands_(jobj, "srcs", uop_srcs_);
+        parseUopOperands_(jobj, "dests", uop_dests_);
+        if (jobj.find("store") != jobj.end())
+        {
+            is_uop_store_ = jobj["store"].get<bool>();
+        }
+
+        if (jobj.find("uops") != jobj.end())
+        {
+            const auto mnemonic = jobj["mnemonic"].get<std::string>();
+            uops_.clear();
+            for (const auto & juop : jobj["uops"])
+            {
+                sparta_assert(juop.find("uops") == juop.end(),
+                              "Micro-ops cannot be cracked further: " << mnemonic);
+                nlohmann::json uop = juop;
+                uop["mnemonic"] = mnemonic + ".uop" + std::to_string(uops_.size());
+                uops_.emplace_back(new InstArchInfo(uop));
+                sparta_assert(uops_.back()->getUopDests().size() <= 1,
+                              "Only one destination per micro-op: " << mnemonic);
+            }
+        }
+    }
+
+    void InstArchInfo::parseUopOperands_(const nlohmann::json & jobj, const std::string & key,
+                                         OperandFieldIDList & operands)
+    {
+        if (jobj.find(key) != jobj.end())
+        {
+            operands.clear();
+            for (const auto & jopnd : jobj[key])
+            {
+                const auto opnd_name = jopnd.get<std::string>();
+                const auto itr = uop_operand_map.find(opnd_name);
+                sparta_assert(itr != uop_operand_map.end(),
+                              "Unknown micro-op operand: " << opnd_name << " for inst: "
+                                                           << jobj["mnemonic"].get<std::string>());
+                operands.emplace_back(itr->second);
+            }
+        }
     }
 
 } // namespace olympia
@@ -10,11 +10,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <cinttypes>
 #include <map>
+#include <vector>
 
 #include "sparta/utils/SpartaSharedPointer.hpp"
+#include "mavis/OpcodeInfo.h"
 
 #include "json.hpp"
 
@@ -48,6 +51,10 @@ namespace olympia
             INT,
             LSU,
             MUL,
+            VINT,
+            VMUL,
+            VDIV,
+            CSR,
             SYS,
             UNKNOWN
         };
@@ -57,6 +64,13 @@ namespace olympia
         using TargetPipeMap = std::map<std::string, TargetPipe>;
         static const TargetPipeMap execution_pipe_map;
 
+        using OperandFieldID = mavis::InstMetaData::OperandFieldID;
+        using OperandFieldMap = std::map<std::string, OperandFieldID>;
+        static const OperandFieldMap uop_operand_map;
+
+        using OperandFieldIDList = std::vector<OperandFieldID>;
+        using UopList = std::vector<PtrType>;
+
         // Called by Mavis during its initialization
         explicit InstArchInfo(const nlohmann::json & jobj) { update(jobj); }
 
@@ -70,13 +84,71 @@ namespace olympia
         //! Return the execution time (latency) of the instruction
         uint32_t getExecutionTime() const { return execute_time_; }
 
+        //! Can the execution unit accept another instruction before
+        //! this one executes ("pipelined" in the uarch file, default)
+        bool isPipelined() const { return is_pipelined_; }
+
+        //! Cycles before the execution unit accepts another instruction
+        //!
+        //! "initiation_interval" in the uarch file, 1 by default.  A
+        //! non-pipelined instruction (div, sqrt) blocks the unit for its
+        //! full latency.
+        uint32_t getInitiationInterval() const
+        {
+            return is_pipelined_ ? std::min(initiation_interval_, execute_time_) : execute_time_;
+        }
+
+        //! Operand width of an early-out (variable latency) instruction,
+        //! 0 if its latency is fixed
+        //!
+        //! "early_out" in the uarch file gives the "width" and "signed"
+        //! of the operands.  The execute pipe shortens the latency by
+        //! the leading zeros of the operand values when they are known.
+        uint32_t getEarlyOutWidth() const { return early_out_width_; }
+
+        //! Are the early-out operands signed
+        bool isEarlyOutSigned() const { return early_out_signed_; }
+
         //! Is this instruction a load/store type?
         bool isLoadStore() const { return is_load_store_; }
 
+        //! Micro-ops this instruction is cracked into (empty if not cracked)
+        //!
+        //! Given by the "uops" list in the uarch file.  Each entry
+        //! has its own "pipe" and "latency" and names the operands of
+        //! the parent instruction it uses in "srcs" and "dests"
+        //! (rs1, rs2, rs3, rd).  A parent destination listed as a
+        //! source orders the uop after the uop that writes it.
+        const UopList & getUops() const { return uops_; }
+
+        //! Number of micro-ops, 1 if the instruction is not cracked
+        uint32_t getNumUops() const { return uops_.empty() ? 1 : uops_.size(); }
+
+        //! Parent operands read by this micro-op
+        const OperandFieldIDList & getUopSources() const { return uop_srcs_; }
+
+        //! Parent operands written by this micro-op
+        const OperandFieldIDList & getUopDests() const { return uop_dests_; }
+
+        //! Is this micro-op a store ("store" in the uarch file)
+        bool isUopStore() const { return is_uop_store_; }
+
       private:
         TargetPipe tgt_pipe_ = TargetPipe::UNKNOWN;
         uint32_t execute_time_ = 0;
+        bool is_pipelined_ = true;
+        uint32_t initiation_interval_ = 1;
+        uint32_t early_out_width_ = 0;
+        bool early_out_signed_ = false;
         bool is_load_store_ = false;
+
+        UopList uops_;
+        OperandFieldIDList uop_srcs_;
+        OperandFieldIDList uop_dests_;
+        bool is_uop_store_ = false;
+
+        void parseUopOperands_(const nlohmann::json & jobj, const std::string & key,
+                               OperandFieldIDList & operands);
     };
 
     inline std::ostream & operator<<(std::ostream & os, const InstArchInfo::TargetPipe & pipe)
@@ -116,6 +188,18 @@ namespace olympia
         case InstArchInfo::TargetPipe::MUL:
             os << "MUL";
             break;
+        case InstArchInfo::TargetPipe::VINT:
+            os << "VINT";
+            break;
+        case InstArchInfo::TargetPipe::VMUL:
+            os << "VMUL";
+            break;
+        case InstArchInfo::TargetPipe::VDIV:
+            os << "VDIV";
+            break;
+        case InstArchInfo::TargetPipe::CSR:
+            os << "CSR";
+            break;
         case InstArchInfo::TargetPipe::SYS:
             os << "SYS";
             break;
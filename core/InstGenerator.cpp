@@ -93,10 +93,14 @@ namespace olympia
         addElement(srcs, "fs1", mavis::InstMetaData::OperandFieldID::RS1, mavis::InstMetaData::OperandTypes::DOUBLE);
         addElement(srcs, "rs2", mavis::InstMetaData::OperandFieldID::RS2, mavis::InstMetaData::OperandTypes::LONG);
         addElement(srcs, "fs2", mavis::InstMetaData::OperandFieldID::RS2, mavis::InstMetaData::OperandTypes::DOUBLE);
+        addElement(srcs, "vs1", mavis::InstMetaData::OperandFieldID::RS1, mavis::InstMetaData::OperandTypes::VECTOR);
+        addElement(srcs, "vs2", mavis::InstMetaData::OperandFieldID::RS2, mavis::InstMetaData::OperandTypes::VECTOR);
+        addElement(srcs, "vs3", mavis::InstMetaData::OperandFieldID::RS3, mavis::InstMetaData::OperandTypes::VECTOR);
 
         mavis::OperandInfo dests;
         addElement(dests, "rd", mavis::InstMetaData::OperandFieldID::RD, mavis::InstMetaData::OperandTypes::LONG);
         addElement(dests, "fd", mavis::InstMetaData::OperandFieldID::RD, mavis::InstMetaData::OperandTypes::DOUBLE);
+        addElement(dests, "vd", mavis::InstMetaData::OperandFieldID::RD, mavis::InstMetaData::OperandTypes::VECTOR);
 
         InstPtr inst;
         if(jinst.find("imm") != jinst.end()) {
@@ -114,6 +118,16 @@ namespace olympia
             inst->setTargetVAddr(vaddr);
         }
 
+        // Vector load/store: "vl" elements of "eew" bits, "stride"
+        // bytes apart (unit stride if not given)
+        if (jinst.find("vl") != jinst.end()) {
+            const uint32_t vl = jinst["vl"].get<uint32_t>();
+            const uint32_t eew = jinst["eew"].get<uint32_t>() / 8;
+            const int64_t stride = (jinst.find("stride") != jinst.end()) ?
+                jinst["stride"].get<int64_t>() : eew;
+            inst->setVectorAccess(vl, eew, stride);
+        }
+
         if (jinst.find("taken") != jinst.end()) {
             const bool taken = jinst["taken"].get<bool>();
             inst->setTakenBranch(taken);
@@ -202,6 +216,24 @@ namespace olympia
                 inst->setTargetVAddr(addrs.front());
                 //For misaligns, more than 1 address is provided
                 //inst->setVAddrVector(std::move(addrs));
+
+                // Vector loads/stores record one access per element
+                if (inst->isVector()) {
+                    const uint32_t eew = mem_accesses.front().getSize();
+                    const int64_t stride = (addrs.size() > 1) ?
+                        static_cast<int64_t>(addrs[1] - addrs[0]) : eew;
+                    inst->setVectorAccess(addrs.size(), eew, stride);
+                }
+            }
+            // Early-out latency depends on the operand values
+            if (inst->getInstArchInfo()->getEarlyOutWidth() > 0)
+            {
+                const auto & src_operands = next_it_->getSourceOperands();
+                if (src_operands.size() >= 2)
+                {
+                    inst->setSourceValues(src_operands[0].getScalarValue(),
+                                          src_operands[1].getScalarValue());
+                }
             }
             if (next_it_->isBranch())
             {
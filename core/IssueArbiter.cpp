@@ -0,0 +1,112 @@
+// <IssueArbiter.cpp> -*- C++ -*-
+
+#include "IssueArbiter.hpp"
+#include "IssueQueue.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+
+#include "sparta/utils/SpartaAssert.hpp"
+
+namespace olympia
+{
+    IssueArbiter::IssueArbiter(const uint32_t num_pipes, const std::string & policy) :
+        policy_(parsePolicy_(policy)),
+        busy_until_(num_pipes, 0)
+    {
+        sparta_assert(num_pipes <= 64, "The issue arbiter supports up to 64 execute pipes");
+    }
+
+    IssueArbiter::Policy IssueArbiter::parsePolicy_(const std::string & policy)
+    {
+        static const std::map<std::string, Policy> policies = {
+            {"per_queue", Policy::PER_QUEUE}, {"oldest_first", Policy::OLDEST_FIRST}};
+        const auto match = policies.find(policy);
+        sparta_assert(match != policies.end(), "Unknown issue_arbitration: " << policy);
+        return match->second;
+    }
+
+    void IssueArbiter::newCycle_(const sparta::Clock::Cycle cycle)
+    {
+        if (cycle == mask_cycle_)
+        {
+            return;
+        }
+        mask_cycle_ = cycle;
+        free_pipes_ = 0;
+        for (uint32_t pipe = 0; pipe < busy_until_.size(); ++pipe)
+        {
+            if (busy_until_[pipe] <= cycle)
+            {
+                free_pipes_ |= uint64_t(1) << pipe;
+            }
+        }
+    }
+
+    void IssueArbiter::setBusyUntil(const uint32_t pipe_number,
+                                    const sparta::Clock::Cycle busy_until,
+                                    const sparta::Clock::Cycle cycle)
+    {
+        newCycle_(cycle);
+        busy_until_[pipe_number] = busy_until;
+        if (busy_until <= cycle)
+        {
+            free_pipes_ |= uint64_t(1) << pipe_number;
+        }
+        else
+        {
+            free_pipes_ &= ~(uint64_t(1) << pipe_number);
+        }
+    }
+
+    uint64_t IssueArbiter::getFreePipes(const sparta::Clock::Cycle cycle)
+    {
+        newCycle_(cycle);
+        return free_pipes_;
+    }
+
+    bool IssueArbiter::arbitrate(const sparta::Clock::Cycle cycle)
+    {
+        if (cycle == arbitrated_cycle_)
+        {
+            return false;
+        }
+        arbitrated_cycle_ = cycle;
+
+        candidates_.clear();
+        uint64_t oldest_not_critical = std::numeric_limits<uint64_t>::max();
+        for (const auto issue_queue : issue_queues_)
+        {
+            uint64_t ready = issue_queue->ready_slots_;
+            while (ready != 0)
+            {
+                const uint32_t slot = __builtin_ctzll(ready);
+                ready &= ready - 1;
+                const InstPtr & inst = issue_queue->slots_[slot];
+                candidates_.push_back(
+                    {inst->getUniqueID(), inst->isCritical(), issue_queue, slot});
+                if (!inst->isCritical())
+                {
+                    oldest_not_critical = std::min(oldest_not_critical, inst->getUniqueID());
+                }
+            }
+        }
+        // Instructions predicted critical first
+        std::sort(candidates_.begin(), candidates_.end(),
+                  [](const Candidate & a, const Candidate & b)
+                  { return (a.critical != b.critical) ? a.critical : (a.age < b.age); });
+
+        for (const auto & candidate : candidates_)
+        {
+            if (getFreePipes(cycle) == 0)
+            {
+                break;
+            }
+            candidate.issue_queue->tryIssue_(candidate.slot,
+                                             candidate.critical
+                                                 && (candidate.age > oldest_not_critical));
+        }
+        return true;
+    }
+} // namespace olympia
@@ -0,0 +1,85 @@
+// <IssueArbiter.hpp> -*- C++ -*-
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "sparta/simulation/Clock.hpp"
+
+namespace olympia
+{
+    class IssueQueue;
+
+    /**
+     * @file   IssueArbiter.hpp
+     * @brief Core wide arbitration of the execute pipes between the issue queues
+     *
+     * The arbiter tracks which execute pipes can take an instruction as
+     * a bitmask indexed by pipe number. The pipes report the cycle they
+     * free up when they take an instruction and when they are cancelled
+     * or flushed, and the mask is rebuilt once per cycle.
+     *
+     * With the per_queue policy each issue queue selects among its own
+     * ready instructions. With oldest_first the first issue queue event
+     * of a cycle arbitrates for every queue of the core: the ready
+     * instructions of all queues are granted pipes, register file read
+     * ports and issue bandwidth oldest first (lowest unique ID). With
+     * either policy instructions predicted critical are selected ahead
+     * of the others.
+     */
+    class IssueArbiter
+    {
+    public:
+        enum class Policy
+        {
+            PER_QUEUE,
+            OLDEST_FIRST
+        };
+
+        IssueArbiter(const uint32_t num_pipes, const std::string & policy);
+
+        Policy getPolicy() const { return policy_; }
+
+        //! Add an issue queue arbitrated by oldest_first
+        void addIssueQueue(IssueQueue* issue_queue) { issue_queues_.emplace_back(issue_queue); }
+
+        //! Pipe pipe_number takes its next instruction at busy_until
+        void setBusyUntil(const uint32_t pipe_number, const sparta::Clock::Cycle busy_until,
+                          const sparta::Clock::Cycle cycle);
+
+        //! Mask of the pipes, by pipe number, that can take an
+        //! instruction this cycle
+        uint64_t getFreePipes(const sparta::Clock::Cycle cycle);
+
+        //! Grant the ready instructions of every issue queue, oldest
+        //! first. Arbitration runs once a cycle, false if it already
+        //! ran this cycle: the caller retries next cycle.
+        bool arbitrate(const sparta::Clock::Cycle cycle);
+
+    private:
+        static Policy parsePolicy_(const std::string & policy);
+
+        void newCycle_(const sparta::Clock::Cycle cycle);
+
+        struct Candidate
+        {
+            uint64_t age;
+            bool critical;
+            IssueQueue* issue_queue;
+            uint32_t slot;
+        };
+
+        const Policy policy_;
+        std::vector<IssueQueue*> issue_queues_;
+        std::vector<sparta::Clock::Cycle> busy_until_;
+        uint64_t free_pipes_ = 0;
+        sparta::Clock::Cycle mask_cycle_ = std::numeric_limits<sparta::Clock::Cycle>::max();
+        sparta::Clock::Cycle arbitrated_cycle_ = std::numeric_limits<sparta::Clock::Cycle>::max();
+
+        // Reused across arbitrations
+        std::vector<Candidate> candidates_;
+    };
+}
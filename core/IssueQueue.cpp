@@ -3,26 +3,44 @@
 #include "IssueQueue.hpp"
 #include "CoreUtils.hpp"
 
+#include <algorithm>
+
 namespace olympia
 {
     const char IssueQueue::name[] = "issue_queue";
 
     IssueQueue::IssueQueue(sparta::TreeNode* node, const IssueQueueParameterSet* p) :
         sparta::Unit(node),
-        ready_queue_(IssueQueueSorter(&iq_sorter)),
         scheduler_size_(p->scheduler_size),
-        in_order_issue_(p->in_order_issue)
+        in_order_issue_(p->in_order_issue),
+        issue_width_(p->issue_width),
+        load_shadow_window_(p->load_shadow_window)
     {
+        setSchedulerSize(scheduler_size_);
+
         in_execute_inst_.registerConsumerHandler(
             CREATE_SPARTA_HANDLER_WITH_DATA(IssueQueue, receiveInstsFromDispatch_, InstPtr));
         in_exe_pipe_done_.registerConsumerHandler(
             CREATE_SPARTA_HANDLER_WITH_DATA(IssueQueue, readyExeUnit_, uint32_t));
         in_reorder_flush_.registerConsumerHandler(CREATE_SPARTA_HANDLER_WITH_DATA(
             IssueQueue, flushInst_, FlushManager::FlushingCriteria));
+        in_load_wakeup_.registerConsumerHandler(
+            CREATE_SPARTA_HANDLER_WITH_DATA(IssueQueue, handleLoadWakeup_, LoadWakeup));
         sparta::StartupEvent(node, CREATE_SPARTA_HANDLER(IssueQueue, setupIssueQueue_));
         node->getParent()->registerForNotification<bool, IssueQueue, &IssueQueue::onROBTerminate_>(
             this, "rob_stopped_notif_channel", false /* ROB maybe not be constructed yet */);
-        iq_sorter.setSorting(p->in_order_issue);
+    }
+
+    void IssueQueue::setSchedulerSize(const uint32_t scheduler_size)
+    {
+        sparta_assert(scheduler_size > 0 && scheduler_size <= MAX_SCHEDULER_SIZE,
+                      "scheduler_size must be between 1 and " << MAX_SCHEDULER_SIZE);
+        sparta_assert(valid_slots_ == 0, "Resizing a scheduler in use");
+        scheduler_size_ = scheduler_size;
+        slots_.resize(scheduler_size_);
+        slot_pipes_.resize(scheduler_size_, 0);
+        age_matrix_.resize(scheduler_size_, 0);
+        slot_exe_pipe_.resize(scheduler_size_, 0);
     }
 
     void IssueQueue::setupIssueQueue_()
@@ -35,7 +53,8 @@ namespace olympia
         {
             cpu_node = getContainer()->getRoot();
         }
-        std::vector<core_types::RegFile> reg_files = {core_types::RF_INTEGER, core_types::RF_FLOAT};
+        std::vector<core_types::RegFile> reg_files = {core_types::RF_INTEGER, core_types::RF_FLOAT,
+                                                      core_types::RF_VECTOR};
         for (const auto rf : reg_files)
         {
             scoreboard_views_[rf].reset(new sparta::ScoreboardView(
@@ -50,21 +69,20 @@ namespace olympia
     {
         output << "Issue Queue Structure Contents" << std::endl;
 
-        output << "Ready Queue Contents:" << std::endl;
-        for (const auto & entry : ready_queue_)
-        {
-            output << '\t' << entry << std::endl;
-        }
         output << "Issue Queue Contents:" << std::endl;
-        for (const auto & entry : issue_queue_)
+        for (uint32_t slot = 0; slot < scheduler_size_; ++slot)
         {
-            output << '\t' << entry << std::endl;
+            if (valid_slots_ & (uint64_t(1) << slot))
+            {
+                output << '\t' << slot << ((ready_slots_ & (uint64_t(1) << slot)) ? " R " : "   ")
+                       << slots_[slot] << std::endl;
+            }
         }
     }
 
     void IssueQueue::onStartingTeardown_()
     {
-        if ((false == rob_stopped_simulation_) && (false == ready_queue_.empty()))
+        if ((false == rob_stopped_simulation_) && (0 != ready_slots_))
         {
             dumpDebugContent_(std::cerr);
             sparta_assert(false, "Issue queue has pending instructions");
@@ -79,62 +97,74 @@ namespace olympia
     void IssueQueue::setExePipeMapping(const InstArchInfo::TargetPipe tgt_pipe,
                                        olympia::ExecutePipe* exe_pipe)
     {
-        if (pipe_exe_pipe_mapping_.find(tgt_pipe) == pipe_exe_pipe_mapping_.end())
+        // An execute pipe serving several target pipes gets one index
+        auto pipe_itr = std::find(pipes_.begin(), pipes_.end(), exe_pipe);
+        if (pipe_itr == pipes_.end())
         {
-            pipe_exe_pipe_mapping_[tgt_pipe] = std::vector<olympia::ExecutePipe*>();
+            sparta_assert(pipes_.size() < 64,
+                          getContainer()->getName() << " supports up to 64 execute pipes");
+            pipe_itr = pipes_.insert(pipes_.end(), exe_pipe);
+            pipe_numbers_.emplace_back(exe_pipe->getPipeNumber());
         }
-        auto pipe_vector = pipe_exe_pipe_mapping_.find(tgt_pipe);
-        pipe_vector->second.emplace_back(exe_pipe);
-        pipes_.push_back(exe_pipe);
+        pipe_exe_pipe_mapping_[tgt_pipe] |= uint64_t(1) << (pipe_itr - pipes_.begin());
     }
 
     void IssueQueue::receiveInstsFromDispatch_(const InstPtr & ex_inst)
     {
         sparta_assert(ex_inst->getStatus() == Inst::Status::DISPATCHED,
                       "Bad instruction status: " << ex_inst);
-        appendIssueQueue_(ex_inst);
-        handleOperandIssueCheck_(ex_inst);
+        const uint32_t slot = appendIssueQueue_(ex_inst);
+        handleOperandIssueCheck_(ex_inst, slot);
     }
 
-    void IssueQueue::handleOperandIssueCheck_(const InstPtr & ex_inst)
+    void IssueQueue::handleOperandIssueCheck_(const InstPtr & ex_inst, const uint32_t slot)
     {
-        // FIXME: Now every source operand should be ready
-        auto reg_file = core_types::RegFile::RF_INTEGER;
-        const auto srcs = ex_inst->getRenameData().getSourceList();
-        if (srcs.size() > 0)
+        // The slot was flushed and possibly reused since the callback
+        // was registered, or a speculative wakeup already readied it
+        const uint64_t slot_bit = uint64_t(1) << slot;
+        if ((slots_[slot] != ex_inst) || ((ready_slots_ | spec_issued_slots_) & slot_bit))
         {
-            reg_file = srcs[0].rf;
+            return;
         }
-        const auto & src_bits = ex_inst->getSrcRegisterBitMask(reg_file);
-        if (scoreboard_views_[reg_file]->isSet(src_bits))
+
+        // Sources can span register files (int <-> float converts, FP
+        // compares), every file's sources must be ready. Wait on the
+        // first file that is not, the callback re-checks all of them so
+        // only one callback is live at a time. Destinations of loads
+        // speculatively woken count as ready.
+        for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
         {
-            // Insert at the end if we are doing in order issue or if the scheduler is
-            // empty
-            ILOG("Sending to issue queue " << ex_inst);
-            // will insert based on if in_order_issue_ is set
-            // if it is, will be first in first out, if not it'll be by age, so by UniqueID (UID)
-            ready_queue_.insert(ex_inst);
-            ev_issue_ready_inst_.schedule(sparta::Clock::Cycle(0));
+            const auto reg_file = static_cast<core_types::RegFile>(rf);
+            const auto & src_bits = ex_inst->getSrcRegisterBitMask(reg_file);
+            if (!scoreboard_views_[reg_file]->isSet(src_bits & ~specReadyBits_(reg_file)))
+            {
+                scoreboard_views_[reg_file]->registerReadyCallback(
+                    src_bits, ex_inst->getCallbackID(),
+                    [this, ex_inst, slot](const sparta::Scoreboard::RegisterBitMask &)
+                    { this->handleOperandIssueCheck_(ex_inst, slot); });
+                ILOG("Instruction NOT ready: " << ex_inst << " "
+                                               << core_types::regfile_names[reg_file]
+                                               << " bits needed:" << sparta::printBitSet(src_bits));
+                return;
+            }
         }
-        else
+
+        ILOG("Sending to issue queue " << ex_inst);
+        // For in order issue the instruction is younger than everything
+        // already ready (first in first out), otherwise its age was set
+        // at insertion
+        if (in_order_issue_)
         {
-            scoreboard_views_[reg_file]->registerReadyCallback(
-                src_bits, ex_inst->getUniqueID(),
-                [this, ex_inst](const sparta::Scoreboard::RegisterBitMask &)
-                { this->handleOperandIssueCheck_(ex_inst); });
-            ILOG("Instruction NOT ready: " << ex_inst
-                                           << " Bits needed:" << sparta::printBitSet(src_bits));
+            orderSlot_(slot, ready_slots_);
         }
+        ready_slots_ |= slot_bit;
+        ev_issue_ready_inst_.schedule(sparta::Clock::Cycle(0));
     }
 
     void IssueQueue::readyExeUnit_(const uint32_t & readyExe)
     {
-        /*
-        TODO:
-        have a map/mask to see which execution units are ready
-        signal port
-        */
-        if (!ready_queue_.empty())
+        // Pipe readiness is read from the free pipe mask at select time
+        if (ready_slots_ != 0)
         {
             ev_issue_ready_inst_.schedule(sparta::Clock::Cycle(0));
         }
@@ -142,54 +172,393 @@ namespace olympia
 
     void IssueQueue::sendReadyInsts_()
     {
-        sparta_assert(ready_queue_.size() <= scheduler_size_,
-                      "ready queue greater than issue queue size: " << scheduler_size_);
-        auto inst_itr = ready_queue_.begin();
-        while (inst_itr != ready_queue_.end())
+        if ((arbiter_ != nullptr)
+            && (arbiter_->getPolicy() == IssueArbiter::Policy::OLDEST_FIRST))
+        {
+            // Selected with the ready instructions of every issue queue,
+            // once a cycle. Ready since this cycle's arbitration, wait
+            // for the next one.
+            if (!arbiter_->arbitrate(getClock()->currentCycle()))
+            {
+                ev_issue_ready_inst_.schedule(1);
+            }
+            return;
+        }
+
+        // Instructions predicted critical go first, oldest first
+        uint64_t candidates = ready_slots_;
+        while ((candidates != 0) && (freePipes_() != 0))
+        {
+            const uint64_t critical = candidates & critical_slots_;
+            const uint32_t slot = selectOldest_((critical != 0) ? critical : candidates);
+            const bool promoted = (critical != 0) && (slot != selectOldest_(candidates));
+            candidates &= ~(uint64_t(1) << slot);
+            if (!tryIssue_(slot, promoted))
+            {
+                break;
+            }
+        }
+    }
+
+    // Execute pipes of this queue able to accept an instruction this
+    // cycle, a mask of indices into pipes_
+    uint64_t IssueQueue::freePipes_()
+    {
+        uint64_t free_pipes = 0;
+        if (arbiter_ != nullptr)
+        {
+            const uint64_t core_free_pipes = arbiter_->getFreePipes(getClock()->currentCycle());
+            for (uint32_t pipe_idx = 0; pipe_idx < pipes_.size(); ++pipe_idx)
+            {
+                free_pipes |= ((core_free_pipes >> pipe_numbers_[pipe_idx]) & 1) << pipe_idx;
+            }
+            return free_pipes;
+        }
+        for (uint32_t pipe_idx = 0; pipe_idx < pipes_.size(); ++pipe_idx)
+        {
+            if (pipes_[pipe_idx]->canAccept())
+            {
+                free_pipes |= uint64_t(1) << pipe_idx;
+            }
+        }
+        return free_pipes;
+    }
+
+    // Issue the instruction in slot if the queue has issue bandwidth
+    // left this cycle, false once it is out of bandwidth. A promoted
+    // instruction was picked over an older one for its criticality.
+    bool IssueQueue::tryIssue_(const uint32_t slot, const bool promoted)
+    {
+        const auto current_cycle = getClock()->currentCycle();
+        if (issue_cycle_ != current_cycle)
+        {
+            issue_cycle_ = current_cycle;
+            num_issued_ = 0;
+        }
+        if ((issue_width_ != 0) && (num_issued_ == issue_width_))
+        {
+            // Out of issue bandwidth, try the rest next cycle
+            ev_issue_ready_inst_.schedule(1);
+            return false;
+        }
+        if (issueSlot_(slot, current_cycle))
         {
-            auto inst = *inst_itr;
-            const auto & valid_exe_pipe = pipe_exe_pipe_mapping_[inst->getPipe()];
-            bool sent = false;
-            for (auto & exe_pipe : valid_exe_pipe)
+            ++num_issued_;
+            if (promoted)
             {
-                if (exe_pipe->canAccept())
+                ++critical_picks_;
+            }
+        }
+        return true;
+    }
+
+    bool IssueQueue::issueSlot_(const uint32_t slot, const sparta::Clock::Cycle current_cycle)
+    {
+        uint64_t avail_pipes = slot_pipes_[slot] & freePipes_();
+        if (avail_pipes == 0)
+        {
+            return false;
+        }
+
+        const InstPtr inst = slots_[slot];
+        if (!inst->getInstArchInfo()->isPipelined())
+        {
+            // Non-pipelined instructions need a free iterative engine,
+            // a finishing engine wakes the issue queue up again
+            uint64_t pipes = avail_pipes;
+            while (pipes != 0)
+            {
+                const uint32_t idx = __builtin_ctzll(pipes);
+                pipes &= pipes - 1;
+                if (!pipes_[idx]->hasFreeEngine())
                 {
-                    ILOG("Sending instruction " << inst << " to exe_pipe " << exe_pipe->getName())
-                    exe_pipe->insertInst(inst);
-                    auto delete_iter = inst_itr++;
-                    sent = true;
-                    ready_queue_.erase(delete_iter);
-                    popIssueQueue_(inst);
-                    ++total_insts_issued_;
-                    break;
+                    avail_pipes &= ~(uint64_t(1) << idx);
                 }
             }
-            if (!sent)
+            if (avail_pipes == 0)
+            {
+                return false;
+            }
+        }
+        if ((bypass_ != nullptr) && bypass_->isPartial())
+        {
+            // Drop the pipes the operands have not reached, by a
+            // forwarding path or the register file
+            uint64_t pipes = avail_pipes;
+            while (pipes != 0)
+            {
+                const uint32_t idx = __builtin_ctzll(pipes);
+                pipes &= pipes - 1;
+                if (!bypass_->isAvailable(inst, pipe_numbers_[idx], current_cycle))
+                {
+                    avail_pipes &= ~(uint64_t(1) << idx);
+                }
+            }
+            if (avail_pipes == 0)
+            {
+                ILOG("Operands not forwarded to a free pipe for " << inst);
+                ++operands_not_forwarded_;
+                ev_issue_ready_inst_.schedule(1);
+                return false;
+            }
+        }
+
+        // Lowest numbered free pipe
+        const uint32_t pipe_idx = __builtin_ctzll(avail_pipes);
+        if ((rf_ports_ != nullptr)
+            && !rf_ports_->reserveReads(inst, pipe_numbers_[pipe_idx], current_cycle))
+        {
+            ILOG("No register file read ports for " << inst);
+            ++rf_read_port_conflicts_;
+            ev_issue_ready_inst_.schedule(1);
+            return false;
+        }
+        auto exe_pipe = pipes_[pipe_idx];
+        ILOG("Sending instruction " << inst << " to exe_pipe " << exe_pipe->getName())
+        const bool spec_issued = dependsOnSpecLoad_(inst);
+        inst->setSpecIssued(spec_issued);
+        exe_pipe->insertInst(inst);
+        if (spec_issued)
+        {
+            // Keep the slot until the load hits
+            ILOG("Speculatively issued " << inst);
+            ready_slots_ &= ~(uint64_t(1) << slot);
+            spec_issued_slots_ |= uint64_t(1) << slot;
+            slot_exe_pipe_[slot] = pipe_idx;
+            ++spec_insts_issued_;
+        }
+        else
+        {
+            popIssueQueue_(slot);
+        }
+        ++total_insts_issued_;
+        return true;
+    }
+
+    // Pick the oldest candidate: the one with no older candidate in its
+    // age matrix row
+    uint32_t IssueQueue::selectOldest_(const uint64_t candidates) const
+    {
+        uint64_t remaining = candidates;
+        while (remaining != 0)
+        {
+            const uint32_t slot = __builtin_ctzll(remaining);
+            if ((age_matrix_[slot] & candidates) == 0)
             {
-                ++inst_itr;
+                return slot;
             }
+            remaining &= remaining - 1;
+        }
+        sparta_assert(false, "Issue queue age matrix has no oldest entry");
+        return 0;
+    }
+
+    // Order slot after older_slots and before everything else
+    void IssueQueue::orderSlot_(const uint32_t slot, const uint64_t older_slots)
+    {
+        const uint64_t slot_bit = uint64_t(1) << slot;
+        for (auto & row : age_matrix_)
+        {
+            row &= ~slot_bit;
         }
+        age_matrix_[slot] = older_slots & ~slot_bit;
+    }
+
+    void IssueQueue::handleLoadWakeup_(const LoadWakeup & wakeup)
+    {
+        const InstPtr & load = wakeup.load;
+        if (wakeup.type == LoadWakeup::Type::WAKEUP)
+        {
+            const auto reg_file = load->getRenameData().getDestination().rf;
+            if ((load_shadow_window_ == 0) || (reg_file == core_types::RegFile::RF_INVALID))
+            {
+                return;
+            }
+            const auto & dest_bits = load->getDestRegisterBitMask(reg_file);
+            if (dest_bits.none())
+            {
+                return;
+            }
+            spec_loads_.push_back({load, reg_file, dest_bits,
+                                   getClock()->currentCycle() + load_shadow_window_});
+            ev_shadow_expire_.schedule(load_shadow_window_);
+
+            // Re-check the dependents still waiting on the load
+            uint64_t waiting = valid_slots_ & ~ready_slots_ & ~spec_issued_slots_;
+            while (waiting != 0)
+            {
+                const uint32_t slot = __builtin_ctzll(waiting);
+                waiting &= waiting - 1;
+                const InstPtr inst = slots_[slot];
+                if ((inst->getSrcRegisterBitMask(reg_file) & dest_bits).any())
+                {
+                    for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+                    {
+                        scoreboard_views_[rf]->clearCallbacks(inst->getCallbackID());
+                    }
+                    handleOperandIssueCheck_(inst, slot);
+                }
+            }
+            return;
+        }
+
+        const auto spec_load = std::find_if(spec_loads_.begin(), spec_loads_.end(),
+                                            [&load](const SpecLoad & entry)
+                                            { return entry.load == load; });
+        if (spec_load == spec_loads_.end())
+        {
+            // Expired or flushed, dependents were already replayed
+            return;
+        }
+        spec_loads_.erase(spec_load);
+
+        if (wakeup.type == LoadWakeup::Type::MISS)
+        {
+            replaySpecDependents_(load);
+        }
+        releaseSpecIssued_();
+    }
+
+    // A load not resolved within the shadow window is treated as a miss
+    void IssueQueue::expireSpecLoads_()
+    {
+        const auto current_cycle = getClock()->currentCycle();
+        auto spec_load = spec_loads_.begin();
+        while (spec_load != spec_loads_.end())
+        {
+            if (spec_load->expire <= current_cycle)
+            {
+                const InstPtr load = spec_load->load;
+                spec_load = spec_loads_.erase(spec_load);
+                ILOG("Shadow window closed for " << load);
+                replaySpecDependents_(load);
+            }
+            else
+            {
+                ++spec_load;
+            }
+        }
+        releaseSpecIssued_();
+    }
+
+    // Free the slots of held instructions no longer depending on a
+    // speculative load
+    void IssueQueue::releaseSpecIssued_()
+    {
+        uint64_t held = spec_issued_slots_;
+        while (held != 0)
+        {
+            const uint32_t slot = __builtin_ctzll(held);
+            held &= held - 1;
+            const InstPtr inst = slots_[slot];
+            if (!dependsOnSpecLoad_(inst))
+            {
+                // The loads hit, publish a result held at execute
+                inst->setSpecIssued(false);
+                if (inst->isDestReadyHeld())
+                {
+                    inst->setDestReadyHeld(false);
+                    const auto reg_file = inst->getRenameData().getDestination().rf;
+                    scoreboard_views_[reg_file]->setReady(
+                        inst->getDestRegisterBitMask(reg_file));
+                }
+                popIssueQueue_(slot);
+            }
+        }
+    }
+
+    // Pull back the dependents of a load that did not hit, they wait on
+    // the scoreboard again. A speculatively issued dependent does not
+    // mark its destination ready before the loads hit, so its own
+    // consumers have not been woken and need no replay.
+    void IssueQueue::replaySpecDependents_(const InstPtr & load)
+    {
+        const auto reg_file = load->getRenameData().getDestination().rf;
+        const auto & dest_bits = load->getDestRegisterBitMask(reg_file);
+        uint64_t dependents = valid_slots_ & (ready_slots_ | spec_issued_slots_);
+        while (dependents != 0)
+        {
+            const uint32_t slot = __builtin_ctzll(dependents);
+            dependents &= dependents - 1;
+            const InstPtr inst = slots_[slot];
+            if ((inst->getSrcRegisterBitMask(reg_file) & dest_bits).none())
+            {
+                continue;
+            }
+
+            const uint64_t slot_bit = uint64_t(1) << slot;
+            if (spec_issued_slots_ & slot_bit)
+            {
+                ILOG("Replaying " << inst << " after a miss of " << load);
+                pipes_[slot_exe_pipe_[slot]]->cancelInst(inst);
+                inst->setStatus(Inst::Status::DISPATCHED);
+                inst->setSpecIssued(false);
+                inst->setDestReadyHeld(false);
+                ++spec_insts_replayed_;
+            }
+            ready_slots_ &= ~slot_bit;
+            spec_issued_slots_ &= ~slot_bit;
+            handleOperandIssueCheck_(inst, slot);
+        }
+
+        // Cancelled instructions may have freed an execute pipe
+        if (ready_slots_ != 0)
+        {
+            ev_issue_ready_inst_.schedule(sparta::Clock::Cycle(0));
+        }
+    }
+
+    core_types::RegisterBitMask IssueQueue::specReadyBits_(const core_types::RegFile rf) const
+    {
+        core_types::RegisterBitMask bits;
+        for (const auto & spec_load : spec_loads_)
+        {
+            if (spec_load.rf == rf)
+            {
+                bits |= spec_load.bits;
+            }
+        }
+        return bits;
+    }
+
+    bool IssueQueue::dependsOnSpecLoad_(const InstPtr & inst) const
+    {
+        for (const auto & spec_load : spec_loads_)
+        {
+            if ((inst->getSrcRegisterBitMask(spec_load.rf) & spec_load.bits).any())
+            {
+                return true;
+            }
+        }
+        return false;
     }
 
     void IssueQueue::flushInst_(const FlushManager::FlushingCriteria & criteria)
     {
         uint32_t credits_to_send = 0;
 
-        auto issue_queue_iter = issue_queue_.begin();
-        while (issue_queue_iter != issue_queue_.end())
+        uint64_t remaining = valid_slots_;
+        while (remaining != 0)
         {
-            auto delete_iter = issue_queue_iter++;
+            const uint32_t slot = __builtin_ctzll(remaining);
+            remaining &= remaining - 1;
 
-            auto inst_ptr = *delete_iter;
+            const InstPtr inst_ptr = slots_[slot];
 
             // Remove flushed instruction from issue queue and clear scoreboard
             // callbacks
             if (criteria.includedInFlush(inst_ptr))
             {
-                issue_queue_.erase(delete_iter);
+                const uint64_t slot_bit = uint64_t(1) << slot;
+                valid_slots_ &= ~slot_bit;
+                ready_slots_ &= ~slot_bit;
+                spec_issued_slots_ &= ~slot_bit;
+                slots_[slot].reset();
 
-                scoreboard_views_[core_types::RegFile::RF_INTEGER]->clearCallbacks(
-                    inst_ptr->getUniqueID());
+                for (uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+                {
+                    scoreboard_views_[rf]->clearCallbacks(inst_ptr->getCallbackID());
+                }
 
                 ++credits_to_send;
 
@@ -204,43 +573,57 @@ namespace olympia
             ILOG("Flush " << credits_to_send << " instructions in issue queue!");
         }
 
-        // Flush instructions in the ready queue
-        auto ready_queue_iter = ready_queue_.begin();
-        while (ready_queue_iter != ready_queue_.end())
-        {
-            auto delete_iter = ready_queue_iter++;
-            auto inst_ptr = *delete_iter;
-            if (criteria.includedInFlush(inst_ptr))
-            {
-                ready_queue_.erase(delete_iter);
-                ILOG("Flush Instruction ID: " << inst_ptr->getUniqueID() << " from ready queue");
-            }
-        }
+        spec_loads_.erase(std::remove_if(spec_loads_.begin(), spec_loads_.end(),
+                                         [&criteria](const SpecLoad & spec_load)
+                                         { return criteria.includedInFlush(spec_load.load); }),
+                          spec_loads_.end());
+        releaseSpecIssued_();
     }
 
-    // Append instruction into issue queue
-    void IssueQueue::appendIssueQueue_(const InstPtr & inst_ptr)
+    // Append instruction into the lowest free issue queue slot
+    uint32_t IssueQueue::appendIssueQueue_(const InstPtr & inst_ptr)
     {
-        sparta_assert(issue_queue_.size() <= scheduler_size_,
-                      "Appending issue queue causes overflows!");
+        const uint64_t all_slots = (scheduler_size_ == MAX_SCHEDULER_SIZE)
+                                     ? ~uint64_t(0)
+                                     : (uint64_t(1) << scheduler_size_) - 1;
+        const uint64_t free_slots = all_slots & ~valid_slots_;
+        sparta_assert(free_slots != 0, "Appending issue queue causes overflows!");
 
-        issue_queue_.emplace_back(inst_ptr);
-    }
+        const auto pipe_mask = pipe_exe_pipe_mapping_.find(inst_ptr->getPipe());
+        sparta_assert(pipe_mask != pipe_exe_pipe_mapping_.end(),
+                      "No execute pipe in " << getContainer()->getName() << " for " << inst_ptr);
 
-    // Pop completed instruction out of issue queue
-    void IssueQueue::popIssueQueue_(const InstPtr & inst_ptr)
-    {
-        // Look for the instruction to be completed, and remove it from issue queue
-        for (auto iter = issue_queue_.begin(); iter != issue_queue_.end(); iter++)
+        const uint32_t slot = __builtin_ctzll(free_slots);
+        slots_[slot] = inst_ptr;
+        slot_pipes_[slot] = pipe_mask->second;
+        if (inst_ptr->isCritical())
         {
-            if (*iter == inst_ptr)
-            {
-                issue_queue_.erase(iter);
-                out_scheduler_credits_.send(
-                    1, 0); // send credit back to dispatch, we now have more room in IQ
-                return;
-            }
+            critical_slots_ |= uint64_t(1) << slot;
+        }
+        else
+        {
+            critical_slots_ &= ~(uint64_t(1) << slot);
         }
-        sparta_assert(false, "Attempt to complete instruction no longer exiting in issue queue!");
+        // Age order, younger than everything in the queue
+        if (!in_order_issue_)
+        {
+            orderSlot_(slot, valid_slots_);
+        }
+        valid_slots_ |= uint64_t(1) << slot;
+        return slot;
+    }
+
+    // Remove an issued instruction from the issue queue
+    void IssueQueue::popIssueQueue_(const uint32_t slot)
+    {
+        const uint64_t slot_bit = uint64_t(1) << slot;
+        sparta_assert(valid_slots_ & slot_bit,
+                      "Attempt to complete instruction no longer exiting in issue queue!");
+        valid_slots_ &= ~slot_bit;
+        ready_slots_ &= ~slot_bit;
+        spec_issued_slots_ &= ~slot_bit;
+        slots_[slot].reset();
+        out_scheduler_credits_.send(
+            1, 0); // send credit back to dispatch, we now have more room in IQ
     }
-} // namespace olympia
\ No newline at end of file
+} // namespace olympia
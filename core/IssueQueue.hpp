@@ -15,12 +15,14 @@
 #include "sparta/simulation/TreeNode.hpp"
 #include "sparta/simulation/Unit.hpp"
 
-#include "sparta/resources/PriorityQueue.hpp"
-
 #include "CoreTypes.hpp"
 #include "ExecutePipe.hpp"
 #include "FlushManager.hpp"
 #include "Inst.hpp"
+#include "BypassNetwork.hpp"
+#include "IssueArbiter.hpp"
+#include "LoadWakeup.hpp"
+#include "RegisterFilePorts.hpp"
 
 namespace olympia
 {
@@ -41,39 +43,11 @@ namespace olympia
             IssueQueueParameterSet(sparta::TreeNode* n) : sparta::ParameterSet(n) {}
             PARAMETER(uint32_t, scheduler_size, 8, "Scheduler queue size")
             PARAMETER(bool, in_order_issue, true, "Force in order issue")
-        };
-
-        class IssueQueueSorter
-        {
-          public:
-            IssueQueueSorter() {}
-
-            IssueQueueSorter(IssueQueueSorter* sorter) : dyn_sorter_(sorter) {}
-
-            bool operator()(const InstPtr existing, const InstPtr to_be_inserted) const
-            {
-                return dyn_sorter_->choose(existing, to_be_inserted);
-            }
-
-            bool choose(const InstPtr existing, const InstPtr to_be_inserted)
-            {
-                if (fifo_)
-                {
-                    // we just want to insert it in the back for fifo order
-                    return false;
-                }
-                else
-                {
-                    // age based insertion
-                    return existing->getUniqueID() > to_be_inserted->getUniqueID();
-                }
-            }
-
-            void setSorting(const bool sort_type) { fifo_ = sort_type; }
-
-          private:
-            bool fifo_ = true;
-            IssueQueueSorter* dyn_sorter_ = this;
+            PARAMETER(uint32_t, issue_width, 0,
+                      "Instructions issued per cycle, 0 for one per execution pipe")
+            PARAMETER(uint32_t, load_shadow_window, 4,
+                      "Cycles a speculative load wakeup waits for its hit/miss before "
+                      "dependents are replayed, 0 ignores speculative wakeups")
         };
 
         IssueQueue(sparta::TreeNode* node, const IssueQueueParameterSet* p);
@@ -85,6 +59,21 @@ namespace olympia
 
         const StringToExePipe & getExePipes() { return exe_pipes_; };
 
+        // Register file read ports arbitrated at issue, unlimited if not set
+        void setRegisterFilePorts(RegisterFilePorts* rf_ports) { rf_ports_ = rf_ports; }
+
+        // Forwarding paths to the pipes, every pipe gets every result if
+        // not set
+        void setBypassNetwork(const BypassNetwork* bypass) { bypass_ = bypass; }
+
+        // Core wide pipe readiness and arbitration, the queue checks its
+        // own pipes and selects alone if not set
+        void setIssueArbiter(IssueArbiter* arbiter) { arbiter_ = arbiter; }
+
+        // Partition of a unified scheduler pool, replaces scheduler_size.
+        // Set before the simulation starts.
+        void setSchedulerSize(const uint32_t scheduler_size);
+
       private:
         // Scoreboards
         using ScoreboardViews =
@@ -94,14 +83,28 @@ namespace olympia
         // Tick events
         sparta::SingleCycleUniqueEvent<> ev_issue_ready_inst_{
             &unit_event_set_, "issue_event", CREATE_SPARTA_HANDLER(IssueQueue, sendReadyInsts_)};
+        sparta::UniqueEvent<> ev_shadow_expire_{
+            &unit_event_set_, "shadow_expire_event",
+            CREATE_SPARTA_HANDLER(IssueQueue, expireSpecLoads_)};
         void setupIssueQueue_();
         void receiveInstsFromDispatch_(const InstPtr &);
         void flushInst_(const FlushManager::FlushingCriteria & criteria);
         void sendReadyInsts_();
+        uint64_t freePipes_();
+        bool tryIssue_(const uint32_t slot, const bool promoted);
+        bool issueSlot_(const uint32_t slot, const sparta::Clock::Cycle current_cycle);
         void readyExeUnit_(const uint32_t &);
-        void appendIssueQueue_(const InstPtr &);
-        void popIssueQueue_(const InstPtr &);
-        void handleOperandIssueCheck_(const InstPtr &);
+        uint32_t appendIssueQueue_(const InstPtr &);
+        void popIssueQueue_(const uint32_t slot);
+        void handleOperandIssueCheck_(const InstPtr &, const uint32_t slot);
+        void orderSlot_(const uint32_t slot, const uint64_t older_slots);
+        uint32_t selectOldest_(const uint64_t candidates) const;
+        void handleLoadWakeup_(const LoadWakeup &);
+        void expireSpecLoads_();
+        void releaseSpecIssued_();
+        void replaySpecDependents_(const InstPtr & load);
+        core_types::RegisterBitMask specReadyBits_(const core_types::RegFile rf) const;
+        bool dependsOnSpecLoad_(const InstPtr & inst) const;
         void onROBTerminate_(const bool & val);
         void onStartingTeardown_() override;
         void dumpDebugContent_(std::ostream & output) const override final;
@@ -114,29 +117,90 @@ namespace olympia
                                                              "out_scheduler_credits"};
         sparta::DataInPort<FlushManager::FlushingCriteria> in_reorder_flush_{
             &unit_port_set_, "in_reorder_flush", sparta::SchedulingPhase::Flush, 1};
+        // Speculative wakeups of load dependents from the LSU
+        sparta::DataInPort<LoadWakeup> in_load_wakeup_{&unit_port_set_, "in_load_wakeup", 0};
         // mapping used to lookup based on execution unit name
         // {"alu0": ExecutePipe0}
         StringToExePipe exe_pipes_;
-        // mapping of target pipe -> vector of execute pipes
-        // i.e {"INT", <ExecutePipe0, ExecutePipe1>}
-        std::unordered_map<InstArchInfo::TargetPipe, std::vector<olympia::ExecutePipe*>>
-            pipe_exe_pipe_mapping_;
-        // storage of what pipes are in this issue queues
+        // mapping of target pipe -> bitmask of indices into pipes_
+        // i.e {"INT", 0b011} for <ExecutePipe0, ExecutePipe1>
+        std::unordered_map<InstArchInfo::TargetPipe, uint64_t> pipe_exe_pipe_mapping_;
+        // storage of what pipes are in this issue queues, one entry per pipe
         std::vector<olympia::ExecutePipe*> pipes_;
+        // Pipe number in the core of each entry of pipes_
+        std::vector<uint32_t> pipe_numbers_;
         std::vector<std::string> exe_unit_str_;
-        IssueQueueSorter iq_sorter;
-        sparta::PriorityQueue<InstPtr, IssueQueueSorter>
-            ready_queue_;                // queue for instructions that have operands ready
-        std::list<InstPtr> issue_queue_; // instructions that have been sent from dispatch,
-                                         // not ready yet
 
-        const uint32_t scheduler_size_;
+        // The scheduler is a fixed array of slots. Bit N of a slot mask
+        // refers to slots_[N]: valid_slots_ holds every instruction sent
+        // from dispatch, ready_slots_ the ones with all operands ready.
+        static constexpr uint32_t MAX_SCHEDULER_SIZE = 64;
+        std::vector<InstPtr> slots_;
+        // Execute pipes that can take the instruction in each slot
+        std::vector<uint64_t> slot_pipes_;
+        // Age matrix, row N is the mask of slots ordered before slot N.
+        // Rows are written at insertion for age order, or when the
+        // instruction becomes ready for in order (FIFO) issue.
+        std::vector<uint64_t> age_matrix_;
+        uint64_t valid_slots_ = 0;
+        uint64_t ready_slots_ = 0;
+        // Slots holding an instruction predicted critical, selected
+        // ahead of the others. Bits of free slots are stale.
+        uint64_t critical_slots_ = 0;
+
+        // Loads that woke their dependents on a predicted cache hit. The
+        // destination reads as ready until the LSU reports the hit or
+        // miss, or the shadow window closes.
+        struct SpecLoad
+        {
+            InstPtr load;
+            core_types::RegFile rf;
+            core_types::RegisterBitMask bits;
+            sparta::Clock::Cycle expire;
+        };
+        std::vector<SpecLoad> spec_loads_;
+        // Slots issued on a speculative wakeup, held until the loads hit
+        // so a miss can replay them
+        uint64_t spec_issued_slots_ = 0;
+        // Index into pipes_ of the pipe each held slot issued to
+        std::vector<uint32_t> slot_exe_pipe_;
+
+        RegisterFilePorts* rf_ports_ = nullptr;
+        const BypassNetwork* bypass_ = nullptr;
+        IssueArbiter* arbiter_ = nullptr;
+
+        // Instructions issued in issue_cycle_, bounded by issue_width_
+        sparta::Clock::Cycle issue_cycle_ = 0;
+        uint32_t num_issued_ = 0;
+
+        uint32_t scheduler_size_;
         const bool in_order_issue_;
+        const uint32_t issue_width_;
+        const uint32_t load_shadow_window_;
         sparta::Counter total_insts_issued_{getStatisticSet(), "total_insts_issued",
                                             "Total instructions issued",
                                             sparta::Counter::COUNT_NORMAL};
+        sparta::Counter spec_insts_issued_{getStatisticSet(), "spec_insts_issued",
+                                           "Instructions issued on a speculative load wakeup",
+                                           sparta::Counter::COUNT_NORMAL};
+        sparta::Counter spec_insts_replayed_{getStatisticSet(), "spec_insts_replayed",
+                                             "Instructions replayed after a load miss",
+                                             sparta::Counter::COUNT_NORMAL};
+        sparta::Counter rf_read_port_conflicts_{
+            getStatisticSet(), "rf_read_port_conflicts",
+            "Ready instructions held for a register file read port",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter operands_not_forwarded_{
+            getStatisticSet(), "operands_not_forwarded",
+            "Ready instructions held for operands not yet forwarded to a free pipe",
+            sparta::Counter::COUNT_NORMAL};
+        sparta::Counter critical_picks_{
+            getStatisticSet(), "critical_picks",
+            "Instructions issued ahead of an older ready instruction for their criticality",
+            sparta::Counter::COUNT_NORMAL};
         bool rob_stopped_simulation_ = false;
         friend class IssueQueueTester;
+        friend class IssueArbiter;
     };
 
     using IssueQueueFactory =
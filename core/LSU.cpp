@@ -1,6 +1,7 @@
 #include "sparta/utils/SpartaAssert.hpp"
 #include "CoreUtils.hpp"
 #include "LSU.hpp"
+#include <algorithm>
 #include <string>
 
 #include "OlympiaAllocators.hpp"
@@ -35,7 +36,10 @@ namespace olympia
             + p->cache_read_stage_length), // Complete stage is after the cache read stage
         ldst_pipeline_("LoadStorePipeline", (complete_stage_ + 1),
                        getClock()), // complete_stage_ + 1 is number of stages
-        allow_speculative_load_exec_(p->allow_speculative_load_exec)
+        allow_speculative_load_exec_(p->allow_speculative_load_exec),
+        cache_line_size_(p->cache_line_size),
+        enable_load_hit_speculation_(p->enable_load_hit_speculation),
+        load_hit_predictor_(p->load_hit_predictor_size, 3)
     {
         sparta_assert(p->mmu_lookup_stage_length > 0,
                       "MMU lookup stage should atleast be one cycle");
@@ -43,6 +47,11 @@ namespace olympia
                       "Cache read stage should atleast be one cycle");
         sparta_assert(p->cache_lookup_stage_length > 0,
                       "Cache lookup stage should atleast be one cycle");
+        sparta_assert((cache_line_size_ > 0) && ((cache_line_size_ & (cache_line_size_ - 1)) == 0),
+                      "Cache line size should be a power of 2");
+        sparta_assert((p->load_hit_predictor_size > 0)
+                          && ((p->load_hit_predictor_size & (p->load_hit_predictor_size - 1)) == 0),
+                      "Load hit predictor size should be a power of 2");
 
         // Pipeline collection config
         ldst_pipeline_.enableCollection(node);
@@ -150,7 +159,8 @@ namespace olympia
     void LSU::setupScoreboard_()
     {
         // Setup scoreboard view upon register file
-        std::vector<core_types::RegFile> reg_files = {core_types::RF_INTEGER, core_types::RF_FLOAT};
+        std::vector<core_types::RegFile> reg_files = {core_types::RF_INTEGER, core_types::RF_FLOAT,
+                                                      core_types::RF_VECTOR};
         // if we ever move to multicore, we only want to have resources look for scoreboard in their cpu
         // if we're running a test where we only have top.rename or top.issue_queue, then we can just use the root
         auto cpu_node = getContainer()->findAncestorByName("core.*");
@@ -171,6 +181,10 @@ namespace olympia
         allocateInstToIssueQueue_(inst_ptr);
         handleOperandIssueCheck_(inst_ptr);
         lsu_insts_dispatched_++;
+        if (inst_ptr->isVector())
+        {
+            ++vector_insts_;
+        }
     }
 
     // Callback from Scoreboard to inform Operand Readiness
@@ -187,19 +201,30 @@ namespace olympia
         if (!instOperandReady_(inst_ptr))
         {
             all_ready = false;
-            const auto & src_bits = inst_ptr->getSrcRegisterBitMask(core_types::RF_INTEGER);
-            scoreboard_views_[core_types::RF_INTEGER]->registerReadyCallback(
-                src_bits, inst_ptr->getUniqueID(),
-                [this, inst_ptr](const sparta::Scoreboard::RegisterBitMask &)
-                { this->handleOperandIssueCheck_(inst_ptr); });
-            ILOG("Instruction NOT ready: " << inst_ptr << " Address Bits needed:"
-                                           << sparta::printBitSet(src_bits));
+            // Vector accesses also wait on their vector sources (store
+            // data, mask). Every register file with sources not ready
+            // calls back, each keeps one callback for the instruction
+            for (const auto rf : {core_types::RF_INTEGER, core_types::RF_VECTOR})
+            {
+                const auto & src_bits = inst_ptr->getSrcRegisterBitMask(rf);
+                if (scoreboard_views_[rf]->isSet(src_bits))
+                {
+                    continue;
+                }
+                scoreboard_views_[rf]->clearCallbacks(inst_ptr->getCallbackID());
+                scoreboard_views_[rf]->registerReadyCallback(
+                    src_bits, inst_ptr->getCallbackID(),
+                    [this, inst_ptr](const sparta::Scoreboard::RegisterBitMask &)
+                    { this->handleOperandIssueCheck_(inst_ptr); });
+                ILOG("Instruction NOT ready: " << inst_ptr << " Address Bits needed:"
+                                               << sparta::printBitSet(src_bits));
+            }
         }
         else
         {
             // we wait for address operand to be ready before checking data operand in the case of
-            // stores this way we avoid two live callbacks
-            if (inst_ptr->isStoreInst())
+            // stores this way we avoid two live callbacks. Vector store data is a source.
+            if (inst_ptr->isStoreInst() && !inst_ptr->isVector())
             {
                 const auto rf = inst_ptr->getRenameData().getDataReg().rf;
                 const auto & data_bits = inst_ptr->getDataRegisterBitMask(rf);
@@ -210,7 +235,7 @@ namespace olympia
                     {
                         all_ready = false;
                         scoreboard_views_[rf]->registerReadyCallback(
-                            data_bits, inst_ptr->getUniqueID(),
+                            data_bits, inst_ptr->getCallbackID(),
                             [this, inst_ptr](const sparta::Scoreboard::RegisterBitMask &)
                             { this->handleOperandIssueCheck_(inst_ptr); });
                         ILOG("Instruction NOT ready: " << inst_ptr << " Bits needed:"
@@ -275,8 +300,13 @@ namespace olympia
         // Instruction issue arbitration
         const LoadStoreInstInfoPtr win_ptr = arbitrateInstIssue_();
         // NOTE:
-        // win_ptr should always point to an instruction ready to be issued
-        // Otherwise assertion error should already be fired in arbitrateInstIssue_()
+        // win_ptr points to an instruction ready to be issued, or is
+        // nullptr if the ready queue only held squashed instructions
+        if (nullptr == win_ptr)
+        {
+            ILOG("No instruction left to issue after a flush");
+            return;
+        }
         ILOG("Arbitrated inst " << win_ptr << " " << win_ptr->getInstPtr());
 
         ++lsu_insts_issued_;
@@ -513,6 +543,7 @@ namespace olympia
             return;
         }
 
+        speculativeWakeup_(load_store_info_ptr);
         out_cache_lookup_req_.send(mem_access_info_ptr);
     }
 
@@ -560,6 +591,8 @@ namespace olympia
             load_store_info_ptr->getMemoryAccessInfoPtr();
         ILOG(mem_access_info_ptr);
 
+        resolveSpeculativeWakeup_(load_store_info_ptr, mem_access_info_ptr->isCacheHit());
+
         if (false == mem_access_info_ptr->isCacheHit())
         {
             ILOG("Cannot complete inst, cache miss: " << mem_access_info_ptr);
@@ -622,6 +655,18 @@ namespace olympia
         ILOG("Completing inst: " << inst_ptr);
         ILOG(mem_access_info_ptr);
 
+        // A vector access completes with its last cache line.  Stores
+        // write their lines once retired, the translation before
+        // retire covers the first line.
+        const bool is_final_pass =
+            is_store_inst ? ((inst_ptr->getStatus() == Inst::Status::RETIRED)
+                             && load_store_info_ptr->getIssueQueueIterator().isValid())
+                          : (inst_ptr->getStatus() != Inst::Status::COMPLETED);
+        if (is_final_pass && issueNextCacheLine_(load_store_info_ptr))
+        {
+            return;
+        }
+
         core_types::RegFile reg_file = core_types::RF_INTEGER;
         const auto & dests = inst_ptr->getDestOpInfoList();
         if (dests.size() > 0)
@@ -753,26 +798,15 @@ namespace olympia
         // Flush instruction issue queue
         flushIssueQueue_(criteria);
         flushReplayBuffer_(criteria);
-        flushReadyQueue_(criteria);
-
-        // Cancel replay events
-        auto flush = [&criteria](const LoadStoreInstInfoPtr & ldst_info_ptr) -> bool {
-            return criteria.includedInFlush(ldst_info_ptr->getInstPtr());
-        };
-        uev_append_ready_.cancelIf(flush);
-        uev_replay_ready_.cancelIf(flush);
 
-        // Cancel issue event already scheduled if no ready-to-issue inst left after flush
-        if (!isReadyToIssueInsts_())
-        {
-            uev_issue_inst_.cancel();
-        }
+        // The ready queue and the replay events are flushed lazily, the
+        // squashed instructions are dropped when they come up
+        // (Inst::isSquashed)
 
         // NOTE:
         // Flush is handled at Flush phase (inbetween PortUpdate phase and Tick phase).
-        // This also guarantees that whenever an instruction issue event happens,
-        // instruction issue arbitration should always succeed, even when flush happens.
-        // Otherwise, assertion error is fired inside arbitrateInstIssue_()
+        // An instruction issue event may find only squashed instructions
+        // in the ready queue, arbitrateInstIssue_() then returns nullptr
     }
 
     void LSU::dumpDebugContent_(std::ostream & output) const
@@ -787,6 +821,10 @@ namespace olympia
     void LSU::replayReady_(const LoadStoreInstInfoPtr & replay_inst_ptr)
     {
         ILOG("Replay inst ready " << replay_inst_ptr);
+        if (replay_inst_ptr->getInstPtr()->isSquashed())
+        {
+            return;
+        }
         // We check in the ldst_queue as the instruction may not be in the replay queue
         if (replay_inst_ptr->getState() == LoadStoreInstInfo::IssueState::NOT_READY)
         {
@@ -821,6 +859,10 @@ namespace olympia
     {
         ILOG("Appending to Ready ready queue event " << replay_inst_ptr->isInReadyQueue() << " "
                                                      << replay_inst_ptr);
+        if (replay_inst_ptr->getInstPtr()->isSquashed())
+        {
+            return;
+        }
         if (!replay_inst_ptr->isInReadyQueue()
             && !replay_inst_ptr->getReplayQueueIterator().isValid())
             appendToReadyQueue_(replay_inst_ptr);
@@ -833,11 +875,40 @@ namespace olympia
     ////////////////////////////////////////////////////////////////////////////////
     // Regular Function/Subroutine Call
     ////////////////////////////////////////////////////////////////////////////////
+    bool LSU::issueNextCacheLine_(const LoadStoreInstInfoPtr & load_store_info_ptr)
+    {
+        const MemoryAccessInfoPtr & mem_access_info_ptr =
+            load_store_info_ptr->getMemoryAccessInfoPtr();
+        if (!mem_access_info_ptr->nextCacheLine())
+        {
+            return false;
+        }
+        ++vector_line_reqs_;
+        ILOG("Vector access line " << mem_access_info_ptr->getCacheLineIdx() + 1 << "/"
+                                   << mem_access_info_ptr->getNumCacheLines() << " vaddr 0x"
+                                   << std::hex << mem_access_info_ptr->getVAddr() << std::dec
+                                   << " " << load_store_info_ptr);
+
+        // Same path as a store re-issued after retire
+        if (allow_speculative_load_exec_)
+        {
+            removeInstFromReplayQueue_(load_store_info_ptr);
+        }
+        load_store_info_ptr->setState(LoadStoreInstInfo::IssueState::READY);
+        load_store_info_ptr->setPriority(LoadStoreInstInfo::IssuePriority::CACHE_PENDING);
+        uev_append_ready_.preparePayload(load_store_info_ptr)->schedule(sparta::Clock::Cycle(0));
+        return true;
+    }
+
     LSU::LoadStoreInstInfoPtr LSU::createLoadStoreInst_(const InstPtr & inst_ptr)
     {
         // Create load/store memory access info
         MemoryAccessInfoPtr mem_info_ptr = sparta::allocate_sparta_shared_pointer<MemoryAccessInfo>(
             memory_access_allocator_, inst_ptr);
+        if (inst_ptr->isVector())
+        {
+            mem_info_ptr->setCacheLines(getVectorCacheLines_(inst_ptr));
+        }
         // Create load/store instruction issue info
         LoadStoreInstInfoPtr inst_info_ptr =
             sparta::allocate_sparta_shared_pointer<LoadStoreInstInfo>(load_store_info_allocator_,
@@ -845,6 +916,39 @@ namespace olympia
         return inst_info_ptr;
     }
 
+    std::vector<sparta::memory::addr_t> LSU::getVectorCacheLines_(const InstPtr & inst_ptr) const
+    {
+        std::vector<sparta::memory::addr_t> line_addrs;
+        const uint32_t eew = inst_ptr->getVectorElementWidth();
+        if (eew == 0)
+        {
+            // No element information from the trace, a single request
+            return line_addrs;
+        }
+
+        // Lines are kept in element order, an element crossing a line
+        // boundary adds both lines.  Only consecutive duplicates are
+        // dropped, a negative or large stride can revisit a line.
+        const sparta::memory::addr_t line_mask = ~sparta::memory::addr_t(cache_line_size_ - 1);
+        const sparta::memory::addr_t base = inst_ptr->getTargetVAddr();
+        line_addrs.emplace_back(base);
+        sparta::memory::addr_t last_line = base & line_mask;
+        for (uint32_t elem = 0; elem < inst_ptr->getVectorLength(); ++elem)
+        {
+            const sparta::memory::addr_t addr = base + elem * inst_ptr->getVectorStride();
+            for (sparta::memory::addr_t line = addr & line_mask; line <= ((addr + eew - 1) & line_mask);
+                 line += cache_line_size_)
+            {
+                if (line != last_line)
+                {
+                    line_addrs.emplace_back(line);
+                    last_line = line;
+                }
+            }
+        }
+        return line_addrs;
+    }
+
     void LSU::allocateInstToIssueQueue_(const InstPtr & inst_ptr)
     {
         auto inst_info_ptr = createLoadStoreInst_(inst_ptr);
@@ -909,7 +1013,69 @@ namespace olympia
     bool LSU::instOperandReady_(const InstPtr & inst_ptr)
     {
         return scoreboard_views_[core_types::RF_INTEGER]->isSet(
-            inst_ptr->getSrcRegisterBitMask(core_types::RF_INTEGER));
+                   inst_ptr->getSrcRegisterBitMask(core_types::RF_INTEGER))
+               && scoreboard_views_[core_types::RF_VECTOR]->isSet(
+                   inst_ptr->getSrcRegisterBitMask(core_types::RF_VECTOR));
+    }
+
+    // Only loads with a destination are woken, vector loads write
+    // their destination over several cache lines
+    void LSU::speculativeWakeup_(const LoadStoreInstInfoPtr & load_store_info_ptr)
+    {
+        const InstPtr & inst_ptr = load_store_info_ptr->getInstPtr();
+        if (!enable_load_hit_speculation_ || inst_ptr->isStoreInst() || inst_ptr->isVector()
+            || inst_ptr->getDestOpInfoList().empty() || load_store_info_ptr->isSpecWakeup())
+        {
+            return;
+        }
+
+        if (loadHitCounter_(inst_ptr) < 2)
+        {
+            ILOG("Load predicted to miss, no speculative wakeup " << inst_ptr);
+            return;
+        }
+
+        ILOG("Speculative wakeup of the dependents of " << inst_ptr);
+        load_store_info_ptr->setSpecWakeup(true);
+        ++load_spec_wakeups_;
+        out_load_wakeup_.send({LoadWakeup::Type::WAKEUP, inst_ptr});
+    }
+
+    void LSU::resolveSpeculativeWakeup_(const LoadStoreInstInfoPtr & load_store_info_ptr,
+                                        const bool cache_hit)
+    {
+        const InstPtr & inst_ptr = load_store_info_ptr->getInstPtr();
+        if (!enable_load_hit_speculation_ || inst_ptr->isStoreInst() || inst_ptr->isVector())
+        {
+            return;
+        }
+
+        uint8_t & counter = loadHitCounter_(inst_ptr);
+        if (cache_hit)
+        {
+            counter = std::min<uint8_t>(counter + 1, 3);
+        }
+        else if (counter > 0)
+        {
+            --counter;
+        }
+
+        if (load_store_info_ptr->isSpecWakeup())
+        {
+            load_store_info_ptr->setSpecWakeup(false);
+            if (!cache_hit)
+            {
+                ILOG("Speculative wakeup cancelled, cache miss " << inst_ptr);
+                ++load_spec_misses_;
+            }
+            out_load_wakeup_.send(
+                {cache_hit ? LoadWakeup::Type::HIT : LoadWakeup::Type::MISS, inst_ptr});
+        }
+    }
+
+    uint8_t & LSU::loadHitCounter_(const InstPtr & inst_ptr)
+    {
+        return load_hit_predictor_[(inst_ptr->getPC() >> 1) & (load_hit_predictor_.size() - 1)];
     }
 
     void LSU::abortYoungerLoads_(const olympia::MemoryAccessInfoPtr & memory_access_info_ptr)
@@ -982,6 +1148,14 @@ namespace olympia
                 if (pipeline_inst == load_store_inst_info_ptr)
                 {
                     ldst_pipeline_.invalidateStage(stage);
+                    if (load_store_inst_info_ptr->isSpecWakeup())
+                    {
+                        // Dependents were woken for data that will not arrive
+                        load_store_inst_info_ptr->setSpecWakeup(false);
+                        ++load_spec_misses_;
+                        out_load_wakeup_.send({LoadWakeup::Type::MISS,
+                                               load_store_inst_info_ptr->getInstPtr()});
+                    }
                     return;
                 }
             }
@@ -1073,9 +1247,32 @@ namespace olympia
     {
         sparta_assert(ready_queue_.size() > 0, "Arbitration fails: issue is empty!");
 
+        // Drop the squashed instructions of a flush
+        while (!ready_queue_.empty() && ready_queue_.top()->getInstPtr()->isSquashed())
+        {
+            ILOG("Dropping squashed instruction from ready queue " << ready_queue_.top());
+            ready_queue_.pop();
+        }
+        if (ready_queue_.empty())
+        {
+            return nullptr;
+        }
+
         LoadStoreInstInfoPtr ready_inst_ = ready_queue_.top();
         ready_queue_.pop();
 
+        if (ready_inst_->getPriority() == LoadStoreInstInfo::IssuePriority::CRITICAL_DISP)
+        {
+            for (const auto & inst : ready_queue_)
+            {
+                if (inst < ready_inst_)
+                {
+                    ++critical_picks_;
+                    break;
+                }
+            }
+        }
+
         return ready_inst_;
     }
 
@@ -1107,7 +1304,9 @@ namespace olympia
             if (inst_info_ptr->getInstPtr() == inst_ptr)
             {
                 inst_info_ptr->setState(LoadStoreInstInfo::IssueState::READY);
-                inst_info_ptr->setPriority(LoadStoreInstInfo::IssuePriority::NEW_DISP);
+                inst_info_ptr->setPriority(inst_ptr->isCritical()
+                                               ? LoadStoreInstInfo::IssuePriority::CRITICAL_DISP
+                                               : LoadStoreInstInfo::IssuePriority::NEW_DISP);
                 // NOTE:
                 // IssuePriority should always be updated before a new issue event is scheduled.
                 // This guarantees that whenever a new instruction issue event is scheduled:
@@ -1251,10 +1450,11 @@ namespace olympia
                 ldst_inst_queue_.erase(delete_iter);
 
                 // Clear any scoreboard callback
-                std::vector<core_types::RegFile> reg_files = {core_types::RF_INTEGER, core_types::RF_FLOAT};
+                std::vector<core_types::RegFile> reg_files = {core_types::RF_INTEGER, core_types::RF_FLOAT,
+                                                              core_types::RF_VECTOR};
                 for(const auto rf : reg_files)
                 {
-                    scoreboard_views_[rf]->clearCallbacks(inst_ptr->getUniqueID());
+                    scoreboard_views_[rf]->clearCallbacks(inst_ptr->getCallbackID());
                 }
 
                 // NOTE:
@@ -1294,21 +1494,6 @@ namespace olympia
         }
     }
 
-    void LSU::flushReadyQueue_(const FlushCriteria & criteria)
-    {
-        auto iter = ready_queue_.begin();
-        while (iter != ready_queue_.end()) {
-            auto inst_ptr = (*iter)->getInstPtr();
-
-            auto delete_iter = iter++;
-
-            if (criteria.includedInFlush(inst_ptr)) {
-                ready_queue_.erase(delete_iter);
-                ILOG("Flushing from ready queue - Instruction ID: " << inst_ptr->getUniqueID());
-            }
-        }
-    }
-
     void LSU::flushReplayBuffer_(const FlushCriteria & criteria)
     {
         auto iter = replay_buffer_.begin();
@@ -28,6 +28,7 @@
 #include "CacheFuncModel.hpp"
 #include "MemoryAccessInfo.hpp"
 #include "LoadStoreInstInfo.hpp"
+#include "LoadWakeup.hpp"
 #include "MMU.hpp"
 #include "DCache.hpp"
 
@@ -58,6 +59,14 @@ namespace olympia
             PARAMETER(uint32_t, mmu_lookup_stage_length, 1, "Length of the mmu lookup stage")
             PARAMETER(uint32_t, cache_lookup_stage_length, 1, "Length of the cache lookup stage")
             PARAMETER(uint32_t, cache_read_stage_length, 1, "Length of the cache read stage")
+            // Vector accesses
+            PARAMETER(uint32_t, cache_line_size, 64,
+                      "Cache line size, vector loads/stores issue one request per line")
+            // Load hit speculation
+            PARAMETER(bool, enable_load_hit_speculation, false,
+                      "Wake load dependents in the issue queues on a predicted cache hit")
+            PARAMETER(uint32_t, load_hit_predictor_size, 256,
+                      "Entries of 2-bit counters in the load hit/miss predictor, indexed by PC")
         };
 
         /*!
@@ -124,6 +133,8 @@ namespace olympia
         sparta::DataOutPort<MemoryAccessInfoPtr> out_cache_lookup_req_{&unit_port_set_,
                                                                        "out_cache_lookup_req", 0};
 
+        sparta::DataOutPort<LoadWakeup> out_load_wakeup_{&unit_port_set_, "out_load_wakeup", 0};
+
         ////////////////////////////////////////////////////////////////////////////////
         // Internal States
         ////////////////////////////////////////////////////////////////////////////////
@@ -137,7 +148,7 @@ namespace olympia
         const uint32_t replay_buffer_size_;
         const uint32_t replay_issue_delay_;
 
-        sparta::PriorityQueue<LoadStoreInstInfoPtr> ready_queue_;
+        sparta::PriorityQueue<LoadStoreInstInfoPtr, LoadStoreInstInfo::ReadyOrder> ready_queue_;
         // MMU unit
         bool mmu_busy_ = false;
 
@@ -170,6 +181,13 @@ namespace olympia
         // LSU Microarchitecture parameters
         const bool allow_speculative_load_exec_;
 
+        // Vector loads/stores are split on this boundary
+        const uint32_t cache_line_size_;
+
+        // Load hit/miss predictor, 2-bit counters, taken to hit at 2 and above
+        const bool enable_load_hit_speculation_;
+        std::vector<uint8_t> load_hit_predictor_;
+
         // ROB stopped simulation early, transactions could still be inflight.
         bool rob_stopped_simulation_ = false;
 
@@ -258,6 +276,12 @@ namespace olympia
 
         void allocateInstToIssueQueue_(const InstPtr & inst_ptr);
 
+        // Cache lines touched by a vector load/store, in element order
+        std::vector<sparta::memory::addr_t> getVectorCacheLines_(const InstPtr & inst_ptr) const;
+
+        // Re-issue a vector access for its next cache line, false on the last line
+        bool issueNextCacheLine_(const LoadStoreInstInfoPtr & load_store_info_ptr);
+
         bool olderStoresExists_(const InstPtr & inst_ptr);
 
         bool allOlderStoresIssued_(const InstPtr & inst_ptr);
@@ -266,6 +290,14 @@ namespace olympia
 
         bool instOperandReady_(const InstPtr &);
 
+        // Wake the dependents of a load predicted to hit in the cache
+        void speculativeWakeup_(const LoadStoreInstInfoPtr &);
+
+        // Train the load hit predictor and confirm or cancel a speculative wakeup
+        void resolveSpeculativeWakeup_(const LoadStoreInstInfoPtr &, const bool cache_hit);
+
+        uint8_t & loadHitCounter_(const InstPtr &);
+
         void abortYoungerLoads_(const olympia::MemoryAccessInfoPtr & memory_access_info_ptr);
 
         // Remove instruction from pipeline which share the same address
@@ -309,9 +341,6 @@ namespace olympia
         // Flush load/store pipeline
         void flushLSPipeline_(const FlushCriteria &);
 
-        // Flush Ready Queue
-        void flushReadyQueue_(const FlushCriteria &);
-
         // Flush Replay Buffer
         void flushReplayBuffer_(const FlushCriteria &);
 
@@ -334,6 +363,25 @@ namespace olympia
                                      "Number of instruction flushes at LSU",
                                      sparta::Counter::COUNT_NORMAL};
 
+        sparta::Counter vector_insts_{getStatisticSet(), "vector_insts",
+                                      "Number of vector load/store instructions dispatched",
+                                      sparta::Counter::COUNT_NORMAL};
+        sparta::Counter vector_line_reqs_{getStatisticSet(), "vector_line_reqs",
+                                          "Number of cache line requests of vector loads/stores",
+                                          sparta::Counter::COUNT_NORMAL};
+
+        sparta::Counter load_spec_wakeups_{getStatisticSet(), "load_spec_wakeups",
+                                           "Number of loads waking dependents on a predicted hit",
+                                           sparta::Counter::COUNT_NORMAL};
+        sparta::Counter load_spec_misses_{getStatisticSet(), "load_spec_misses",
+                                          "Number of speculative wakeups cancelled by a miss",
+                                          sparta::Counter::COUNT_NORMAL};
+
+        sparta::Counter critical_picks_{
+            getStatisticSet(), "critical_picks",
+            "Loads/stores issued ahead of an older ready one for their criticality",
+            sparta::Counter::COUNT_NORMAL};
+
         sparta::Counter biu_reqs_{getStatisticSet(), "biu_reqs", "Number of BIU reqs",
                                   sparta::Counter::COUNT_NORMAL};
 
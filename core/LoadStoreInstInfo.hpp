@@ -25,6 +25,7 @@ namespace olympia
             CACHE_PENDING, // Wait for another outstanding miss finish
             MMU_RELOAD,    // Receive for mss ack, waiting for mmu re-access
             MMU_PENDING,   // Wait for another outstanding miss finish
+            CRITICAL_DISP, // Wait for new issue, predicted critical
             NEW_DISP,      // Wait for new issue
             LOWEST,
             NUM_OF_PRIORITIES,
@@ -125,16 +126,40 @@ namespace olympia
 
         void setInReadyQueue(bool inReadyQueue) { in_ready_queue_ = inReadyQueue; }
 
+        // The load woke its dependents on a predicted cache hit, the
+        // issue queues are waiting for the hit/miss
+        bool isSpecWakeup() const { return spec_wakeup_; }
+
+        void setSpecWakeup(bool spec_wakeup) { spec_wakeup_ = spec_wakeup; }
+
         friend bool operator<(const LoadStoreInstInfoPtr & lhs, const LoadStoreInstInfoPtr & rhs)
         {
             return lhs->getInstUniqueID() < rhs->getInstUniqueID();
         }
 
+        // Ready queue order: new dispatches predicted critical first,
+        // then oldest first
+        struct ReadyOrder
+        {
+            bool operator()(const LoadStoreInstInfoPtr & lhs,
+                            const LoadStoreInstInfoPtr & rhs) const
+            {
+                const bool lhs_critical = lhs->getPriority() == IssuePriority::CRITICAL_DISP;
+                const bool rhs_critical = rhs->getPriority() == IssuePriority::CRITICAL_DISP;
+                if (lhs_critical != rhs_critical)
+                {
+                    return lhs_critical;
+                }
+                return lhs < rhs;
+            }
+        };
+
       private:
         MemoryAccessInfoPtr mem_access_info_ptr_;
         sparta::State<IssuePriority> rank_;
         sparta::State<IssueState> state_;
         bool in_ready_queue_;
+        bool spec_wakeup_ = false;
     }; // class LoadStoreInstInfo
 
     using LoadStoreInstInfoAllocator = sparta::SpartaSharedPointerAllocator<LoadStoreInstInfo>;
@@ -159,6 +184,9 @@ namespace olympia
         case LoadStoreInstInfo::IssuePriority::MMU_PENDING:
             os << "(mmu_pending)";
             break;
+        case LoadStoreInstInfo::IssuePriority::CRITICAL_DISP:
+            os << "(critical_disp)";
+            break;
         case LoadStoreInstInfo::IssuePriority::NEW_DISP:
             os << "(new_disp)";
             break;
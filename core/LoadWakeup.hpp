@@ -0,0 +1,51 @@
+// <LoadWakeup.hpp> -*- C++ -*-
+
+#pragma once
+
+#include <iostream>
+
+#include "Inst.hpp"
+
+namespace olympia
+{
+    /**
+     * \struct LoadWakeup
+     * \brief Speculative wakeup of a load's dependents, sent from the
+     *        LSU to the issue queues
+     *
+     * The LSU sends WAKEUP when a load predicted to hit in the L1 makes
+     * its cache lookup, dependents may issue before the data returns.
+     * HIT or MISS follows once the cache read resolves the access.  On
+     * a MISS the issue queues replay the dependents issued in the shadow
+     * of the wakeup.
+     */
+    struct LoadWakeup
+    {
+        enum class Type
+        {
+            WAKEUP,
+            HIT,
+            MISS
+        };
+
+        Type type;
+        InstPtr load;
+    };
+
+    inline std::ostream & operator<<(std::ostream & os, const LoadWakeup & wakeup)
+    {
+        switch (wakeup.type)
+        {
+        case LoadWakeup::Type::WAKEUP:
+            os << "wakeup ";
+            break;
+        case LoadWakeup::Type::HIT:
+            os << "hit ";
+            break;
+        case LoadWakeup::Type::MISS:
+            os << "miss ";
+            break;
+        }
+        return os << wakeup.load;
+    }
+} // namespace olympia
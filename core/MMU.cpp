@@ -19,8 +19,7 @@ namespace olympia
 
     bool MMU::memLookup_(const MemoryAccessInfoPtr & mem_access_info_ptr)
     {
-        const InstPtr & inst_ptr = mem_access_info_ptr->getInstPtr();
-        uint64_t vaddr = inst_ptr->getTargetVAddr();
+        uint64_t vaddr = mem_access_info_ptr->getVAddr();
 
         bool tlb_hit = tlb_always_hit_;
 
@@ -88,7 +87,7 @@ namespace olympia
     void MMU::lookupInst_()
     {
         busy_ = false;
-        reloadTLB_(mmu_pending_inst_->getInstPtr()->getTargetVAddr());
+        reloadTLB_(mmu_pending_inst_->getVAddr());
         out_lsu_lookup_req_.send(mmu_pending_inst_);
     }
 
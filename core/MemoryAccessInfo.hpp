@@ -69,6 +69,7 @@ namespace olympia
 
         MemoryAccessInfo(const InstPtr & inst_ptr) :
             ldst_inst_ptr_(inst_ptr),
+            vaddr_(inst_ptr == nullptr ? 0 : inst_ptr->getTargetVAddr()),
             phy_addr_ready_(false),
             mmu_access_state_(MMUState::NO_ACCESS),
 
@@ -104,9 +105,40 @@ namespace olympia
 
         bool getPhyAddrStatus() const { return phy_addr_ready_; }
 
-        uint64_t getPhyAddr() const { return ldst_inst_ptr_->getRAdr(); }
+        uint64_t getPhyAddr() const { return Inst::getRAdrOf(vaddr_); }
 
-        sparta::memory::addr_t getVAddr() const { return ldst_inst_ptr_->getTargetVAddr(); }
+        sparta::memory::addr_t getVAddr() const { return vaddr_; }
+
+        // A vector access is split into one request per cache line,
+        // the first line is the instruction's target address
+        void setCacheLines(std::vector<sparta::memory::addr_t> && line_addrs)
+        {
+            line_addrs_ = std::move(line_addrs);
+            line_idx_ = 0;
+        }
+
+        uint32_t getNumCacheLines() const
+        {
+            return line_addrs_.empty() ? 1 : line_addrs_.size();
+        }
+
+        uint32_t getCacheLineIdx() const { return line_idx_; }
+
+        // Move to the next cache line of a vector access, the request
+        // is translated and looked up again.  False on the last line
+        bool nextCacheLine()
+        {
+            if (line_idx_ + 1 >= line_addrs_.size())
+            {
+                return false;
+            }
+            vaddr_ = line_addrs_[++line_idx_];
+            phy_addr_ready_ = false;
+            mmu_access_state_ = MMUState::NO_ACCESS;
+            cache_access_state_ = CacheState::NO_ACCESS;
+            cache_data_ready_ = false;
+            return true;
+        }
 
         void setSrcUnit(const ArchUnit & src_unit) { src_ = src_unit; }
 
@@ -155,6 +187,11 @@ namespace olympia
         // load/store instruction pointer
         InstPtr ldst_inst_ptr_;
 
+        // Address of this request, a cache line of a vector access
+        sparta::memory::addr_t vaddr_;
+        std::vector<sparta::memory::addr_t> line_addrs_;
+        uint32_t line_idx_ = 0;
+
         // Indicate MMU address translation status
         bool phy_addr_ready_;
 
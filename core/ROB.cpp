@@ -28,20 +28,36 @@ namespace olympia
                      "total_number_of_flushes",
                      "The total number of flushes performed by the ROB",
                      sparta::Counter::COUNT_NORMAL),
+        num_sys_flushes_avoided_(&unit_stat_set_,
+                                 "num_sys_flushes_avoided",
+                                 "Renamed CSR reads retired without a serializing flush",
+                                 sparta::Counter::COUNT_NORMAL),
         overall_ipc_si_(&stat_ipc_),
         period_ipc_si_(&stat_ipc_),
         retire_timeout_interval_(p->retire_timeout_interval),
         num_to_retire_(p->num_to_retire),
         num_insts_to_retire_(p->num_insts_to_retire),
         retire_heartbeat_(p->retire_heartbeat),
-        reorder_buffer_("ReorderBuffer", p->retire_queue_depth,
-                        node->getClock(), &unit_stat_set_)
+        num_threads_(olympia::coreutils::getNumThreads(node->getParent())),
+        expected_program_id_(num_threads_, 1),
+        expect_flush_(num_threads_, false)
     {
         // Set a cycle delay on the retire, just for kicks
         ev_retire_.setDelay(1);
 
-        // Set up the reorder buffer to support pipeline collection.
-        reorder_buffer_.enableCollection(node);
+        for(uint32_t thread_id = 0; thread_id < num_threads_; ++thread_id)
+        {
+            const std::string suffix = (thread_id == 0) ? "" : "_thread" + std::to_string(thread_id);
+            reorder_buffers_.emplace_back(new InstQueue("ReorderBuffer" + suffix, p->retire_queue_depth,
+                                                        node->getClock(), &unit_stat_set_));
+            // Set up the reorder buffer to support pipeline collection.
+            reorder_buffers_.back()->enableCollection(node);
+
+            thread_retired_.emplace_back(new sparta::Counter(
+                &unit_stat_set_, "total_number_retired_thread" + std::to_string(thread_id),
+                "Instructions retired by hardware thread " + std::to_string(thread_id),
+                sparta::Counter::COUNT_NORMAL));
+        }
 
         in_reorder_buffer_write_.
             registerConsumerHandler(CREATE_SPARTA_HANDLER_WITH_DATA(ROB, robAppended_, InstGroup));
@@ -74,7 +90,7 @@ namespace olympia
     void ROB::sendInitialCredits_()
     {
         setupScoreboardView_() ;
-        out_reorder_buffer_credits_.send(reorder_buffer_.capacity());
+        out_reorder_buffer_credits_.send(reorder_buffers_.front()->capacity());
         ev_ensure_forward_progress_.schedule(retire_timeout_interval_);
     }
 
@@ -83,7 +99,7 @@ namespace olympia
     // directly, albeit inefficient and superfluous here...
     void ROB::robAppended_(const InstGroup &) {
         for(auto & i : *in_reorder_buffer_write_.pullData()) {
-            reorder_buffer_.push(i);
+            reorder_buffers_[i->getThreadID()]->push(i);
             ILOG("retire appended: " << i);
         }
 
@@ -92,21 +108,27 @@ namespace olympia
 
     void ROB::handleFlush_(const FlushManager::FlushingCriteria & criteria)
     {
-        sparta_assert(expect_flush_, "Received a flush, but didn't expect one");
-
-        expect_flush_ = false;
+        // The flush is the ROB's own or a branch resolved at execute
+        const uint32_t thread_id = criteria.getThreadID();
+        const bool execute_flush =
+            (criteria.getCause() == FlushManager::FlushCause::MISPREDICTION)
+            && criteria.getInstPtr()->isResolvedAtExecute();
+        sparta_assert(expect_flush_[thread_id] || execute_flush,
+                      "Received a flush, but didn't expect one");
+        expect_flush_[thread_id] = false;
 
         uint32_t credits_to_send = 0;
 
-        // Clean up internals and send new credit count
-        while (reorder_buffer_.size())
+        // Clean up internals of the flushed thread and send new credit count
+        auto & reorder_buffer = *reorder_buffers_[thread_id];
+        while (reorder_buffer.size())
         {
-            auto youngest_inst = reorder_buffer_.back();
+            auto youngest_inst = reorder_buffer.back();
             if (criteria.includedInFlush(youngest_inst))
             {
                 ILOG("flushing " << youngest_inst);
                 youngest_inst->setStatus(Inst::Status::FLUSHED);
-                reorder_buffer_.pop_back();
+                reorder_buffer.pop_back();
                 ++credits_to_send;
             }
             else
@@ -118,26 +140,64 @@ namespace olympia
     }
 
     void ROB::retireInstructions_()
+    {
+        // The threads share the retire width, the first thread to
+        // retire rotates every session
+        uint32_t retired_this_cycle = 0;
+        for(uint32_t i = 0; i < num_threads_; ++i)
+        {
+            retireThread_((retire_thread_ + i) % num_threads_, retired_this_cycle);
+            if(rob_stopped_simulation_) {
+                break;
+            }
+        }
+        retire_thread_ = (retire_thread_ + 1) % num_threads_;
+
+        if(retired_this_cycle != 0) {
+            out_reorder_buffer_credits_.send(retired_this_cycle);
+            last_retirement_ = getClock()->currentCycle();
+        }
+    }
+
+    void ROB::retireThread_(uint32_t thread_id, uint32_t & retired_this_cycle)
     {
         // ROB is expecting a flush (back to itself)
-        if(expect_flush_) {
+        if(expect_flush_[thread_id]) {
             return;
         }
 
-        const uint32_t num_to_retire = std::min(reorder_buffer_.size(), num_to_retire_);
+        auto & reorder_buffer = *reorder_buffers_[thread_id];
+        uint32_t num_to_retire = std::min(reorder_buffer.size(), num_to_retire_ - retired_this_cycle);
 
-        ILOG("num to retire: " << num_to_retire);
+        ILOG("num to retire: " << num_to_retire << " thread: " << thread_id);
 
-        uint32_t retired_this_cycle = 0;
         for(uint32_t i = 0; i < num_to_retire; ++i)
         {
-            auto ex_inst_ptr = reorder_buffer_.access(0);
+            auto ex_inst_ptr = reorder_buffer.access(0);
             sparta_assert(nullptr != ex_inst_ptr);
             auto & ex_inst = *ex_inst_ptr;
             sparta_assert(ex_inst.isSpeculative() == false,
                           "Uh, oh!  A speculative instruction is being retired: " << ex_inst);
             if(ex_inst.getStatus() == Inst::Status::COMPLETED)
             {
+                // The micro-ops of a cracked instruction retire together
+                if(ex_inst.isCracked() && (ex_inst.getUopIndex() == 0))
+                {
+                    const uint32_t num_uops = ex_inst.getNumUops();
+                    InstPtr incomplete_uop;
+                    if(false == uopsCompleted_(reorder_buffer, num_uops, incomplete_uop)) {
+                        break;
+                    }
+                    if(i + num_uops > num_to_retire) {
+                        // Does not fit in this cycle's retire width,
+                        // unless it is the first thing retired
+                        if(retired_this_cycle != 0) {
+                            break;
+                        }
+                        num_to_retire = i + num_uops;
+                    }
+                }
+
                 // UPDATE:
                 ex_inst.setStatus(Inst::Status::RETIRED);
                 if (ex_inst.isStoreInst()) {
@@ -146,19 +206,18 @@ namespace olympia
                 // sending retired instruction to rename
                 out_rob_retire_ack_rename_.send(ex_inst_ptr);
 
-                ++num_retired_;
                 ++retired_this_cycle;
-                reorder_buffer_.pop();
+                reorder_buffer.pop();
 
                 ILOG("retiring " << ex_inst);
 
                 retire_event_.collect(*ex_inst_ptr);
 
                 // Use the program ID to verify that the program order has been maintained.
-                sparta_assert(ex_inst.getProgramID() == expected_program_id_,
+                sparta_assert(ex_inst.getProgramID() == expected_program_id_[thread_id],
                     "\nUnexpected program ID when retiring instruction"
                     << "\n(suggests wrong program order)"
-                    << "\n expected: " << expected_program_id_
+                    << "\n expected: " << expected_program_id_[thread_id]
                     << "\n received: " << ex_inst.getProgramID()
                     << "\n UID: " << ex_inst_ptr->getMavisUid()
                     << "\n incr: " << ex_inst_ptr->getProgramIDIncrement()
@@ -166,7 +225,15 @@ namespace olympia
 
                 //The fused op records the number of insts that
                 //were eliminated and adjusts the progID as needed 
-                expected_program_id_ += ex_inst.getProgramIDIncrement();
+                expected_program_id_[thread_id] += ex_inst.getProgramIDIncrement();
+
+                // Only the last micro-op of a cracked instruction
+                // advances the program ID, count instructions, not uops
+                if(SPARTA_EXPECT_FALSE(ex_inst.getProgramIDIncrement() == 0)) {
+                    continue;
+                }
+                ++num_retired_;
+                ++(*thread_retired_[thread_id]);
 
                 if(SPARTA_EXPECT_FALSE((num_retired_ % retire_heartbeat_) == 0)) {
                     std::cout << "olympia: Retired " << num_retired_.get()
@@ -184,12 +251,13 @@ namespace olympia
                     break;
                 }
 
-                // Is this a misprdicted branch requiring a refetch?
-                if(ex_inst.isMispredicted()) {
+                // Is this a misprdicted branch requiring a refetch? One
+                // resolved at execute has flushed already
+                if(ex_inst.isMispredicted() && !ex_inst.isResolvedAtExecute()) {
                     FlushManager::FlushingCriteria criteria
                         (FlushManager::FlushCause::MISPREDICTION, ex_inst_ptr);
                     out_retire_flush_.send(criteria);
-                    expect_flush_ = true;
+                    expect_flush_[thread_id] = true;
                     break;
                 }
 
@@ -198,35 +266,74 @@ namespace olympia
                 {
                     retireSysInst_(ex_inst_ptr);
                 }
+                else if(ex_inst.isCsrRenamed()) {
+                    ++num_sys_flushes_avoided_;
+                }
             }
             else {
                 break;
             }
         }
 
-        if(false == reorder_buffer_.empty()) {
-            const auto & oldest_inst = reorder_buffer_.front();
-            if(oldest_inst->getStatus() == Inst::Status::COMPLETED) {
+        if(false == reorder_buffer.empty()) {
+            const auto & oldest_inst = reorder_buffer.front();
+            InstPtr incomplete_uop;
+            if(oldest_inst->isCracked() && (oldest_inst->getUopIndex() == 0) &&
+               (false == uopsCompleted_(reorder_buffer, oldest_inst->getNumUops(), incomplete_uop)))
+            {
+                // Head of a cracked instruction is waiting on its other
+                // micro-ops, wake up when the next one completes. One not
+                // yet in the ROB wakes us up when it is appended.
+                if(incomplete_uop && (false == incomplete_uop->isMarkedOldest())) {
+                    ILOG("set oldest uop: " << incomplete_uop);
+                    incomplete_uop->setOldest(true, &ev_retire_);
+                }
+            }
+            else if(oldest_inst->getStatus() == Inst::Status::COMPLETED) {
                 ILOG("oldest is marked completed: " << oldest_inst);
                 ev_retire_.schedule();
             }
             else if(false == oldest_inst->isMarkedOldest()) {
                 ILOG("set oldest: " << oldest_inst);
                 oldest_inst->setOldest(true, &ev_retire_);
+                if(oldest_inst->isLoadStoreInst() && !oldest_inst->isStoreInst() &&
+                   out_rob_critical_load_.isBound()) {
+                    out_rob_critical_load_.send(oldest_inst);
+                }
             }
         }
+    }
 
-        if(retired_this_cycle != 0) {
-            out_reorder_buffer_credits_.send(retired_this_cycle);
-            last_retirement_ = getClock()->currentCycle();
+    // True if all num_uops micro-ops of the cracked instruction at the
+    // head of the thread's ROB have completed. Otherwise incomplete_uop
+    // is the first one that has not, or nullptr if it is not in the ROB yet.
+    bool ROB::uopsCompleted_(const InstQueue & reorder_buffer, uint32_t num_uops,
+                             InstPtr & incomplete_uop) const
+    {
+        incomplete_uop.reset();
+        for(uint32_t idx = 0; idx < num_uops; ++idx) {
+            if(idx >= reorder_buffer.size()) {
+                return false;
+            }
+            const auto & uop = reorder_buffer.read(idx);
+            if(uop->getStatus() != Inst::Status::COMPLETED) {
+                incomplete_uop = uop;
+                return false;
+            }
         }
+        return true;
     }
 
     void ROB::dumpDebugContent_(std::ostream& output) const
     {
         output << "ROB Contents" << std::endl;
-        for(const auto & entry : reorder_buffer_) {
-            output << '\t' << entry << std::endl;
+        for(uint32_t thread_id = 0; thread_id < num_threads_; ++thread_id) {
+            if(num_threads_ > 1) {
+                output << "Thread " << thread_id << std::endl;
+            }
+            for(const auto & entry : *reorder_buffers_[thread_id]) {
+                output << '\t' << entry << std::endl;
+            }
         }
     }
 
@@ -244,7 +351,9 @@ namespace olympia
     }
 
     void ROB::onStartingTeardown_() {
-        if ((reorder_buffer_.size() > 0) && (false == rob_stopped_simulation_)) {
+        const bool rob_empty = std::all_of(reorder_buffers_.begin(), reorder_buffers_.end(),
+                                           [](const auto & rob) { return rob->empty(); });
+        if ((false == rob_empty) && (false == rob_stopped_simulation_)) {
             std::cerr << "WARNING! Simulation is ending, but the ROB didn't stop it.  Lock up situation?" << std::endl;
             dumpDebugContent_(std::cerr);
         }
@@ -266,7 +375,7 @@ namespace olympia
 
         FlushManager::FlushingCriteria criteria(FlushManager::FlushCause::POST_SYNC, ex_inst);
                     out_retire_flush_.send(criteria);
-                    expect_flush_ = true;
+                    expect_flush_[ex_inst->getThreadID()] = true;
                     ++num_flushes_;
                     ILOG("Instigating flush due to SYS instruction... " << *ex_inst);
 
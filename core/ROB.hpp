@@ -1,7 +1,9 @@
 // <ROB.hpp> -*- C++ -*-
 
 #pragma once
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "sparta/ports/DataPort.hpp"
 #include "sparta/events/UniqueEvent.hpp"
@@ -75,6 +77,7 @@ namespace olympia
         sparta::StatisticDef       stat_ipc_;            // A simple expression to calculate IPC
         sparta::Counter            num_retired_;         // Running counter of number instructions retired
         sparta::Counter            num_flushes_;         // Number of flushes
+        sparta::Counter            num_sys_flushes_avoided_; // Renamed CSR reads retired without a flush
         sparta::StatisticInstance  overall_ipc_si_;      // An overall IPC statistic instance starting at time == 0
         sparta::StatisticInstance  period_ipc_si_;       // An IPC counter for the period between retirement heartbeats
 
@@ -83,17 +86,26 @@ namespace olympia
         const uint32_t num_to_retire_;
         const uint32_t num_insts_to_retire_; // parameter from ilimit
         const uint64_t retire_heartbeat_;    // Retire heartbeat interval
+        const uint32_t num_threads_;         // Hardware threads of the core
 
-        InstQueue      reorder_buffer_;
+        // Reorder buffer of each hardware thread. They share the
+        // retire_queue_depth entries given to Dispatch as credits.
+        std::vector<std::unique_ptr<InstQueue>> reorder_buffers_;
+
+        // Thread that retires first, rotated every retire session
+        uint32_t retire_thread_ = 0;
+
+        // Instructions retired by each thread
+        std::vector<std::unique_ptr<sparta::Counter>> thread_retired_;
 
         // Bool that indicates if the ROB stopped simulation.  If
         // false and there are still instructions in the reorder
         // buffer, the machine probably has a lock up
         bool rob_stopped_simulation_{false};
 
-        // Track a program ID to ensure the trace stream matches
-        // at retirement.
-        uint64_t expected_program_id_ = 1;
+        // Track a program ID per thread to ensure the trace stream
+        // matches at retirement.
+        std::vector<uint64_t> expected_program_id_;
 
         // Ports used by the ROB
         sparta::DataInPort<InstGroupPtr> in_reorder_buffer_write_{&unit_port_set_, "in_reorder_buffer_write", 1};
@@ -103,13 +115,15 @@ namespace olympia
         // UPDATE:
         sparta::DataOutPort<InstPtr> out_rob_retire_ack_         {&unit_port_set_, "out_rob_retire_ack"};
         sparta::DataOutPort<InstPtr> out_rob_retire_ack_rename_  {&unit_port_set_, "out_rob_retire_ack_rename"};
+        // A load at the head stalling retirement, trains Dispatch's criticality predictor
+        sparta::DataOutPort<InstPtr> out_rob_critical_load_      {&unit_port_set_, "out_rob_critical_load"};
 
         // For flush
         sparta::DataInPort<FlushManager::FlushingCriteria> in_reorder_flush_
              {&unit_port_set_, "in_reorder_flush", sparta::SchedulingPhase::Flush, 1};
 
-        // Is the ROB expecting a flush?
-        bool expect_flush_ = false;
+        // Is the ROB expecting a flush? Per thread
+        std::vector<bool> expect_flush_;
 
         // Events used by the ROB
         sparta::UniqueEvent<> ev_retire_ {&unit_event_set_, "retire_insts",
@@ -129,12 +143,15 @@ namespace olympia
         void sendInitialCredits_();
         void robAppended_(const InstGroup &);
         void retireInstructions_();
+        void retireThread_(uint32_t thread_id, uint32_t & retired_this_cycle);
         void checkForwardProgress_();
         void handleFlush_(const FlushManager::FlushingCriteria & criteria);
         void dumpDebugContent_(std::ostream& output) const override final;
         void onStartingTeardown_() override final;
 
         void retireSysInst_(InstPtr & );
+        bool uopsCompleted_(const InstQueue & reorder_buffer, uint32_t num_uops,
+                            InstPtr & incomplete_uop) const;
 
         void setupScoreboardView_() ;
         // Scoreboards
@@ -0,0 +1,110 @@
+// <RegisterFilePorts.hpp> -*- C++ -*-
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#include "sparta/simulation/Clock.hpp"
+
+#include "BypassNetwork.hpp"
+#include "CoreTypes.hpp"
+#include "Inst.hpp"
+
+namespace olympia
+{
+    /**
+     * @file   RegisterFilePorts.hpp
+     * @brief Per cycle read and write port arbitration of the register files
+     *
+     * Issue reserves a read port for each source operand, writeback a
+     * write port for the destination. A port count of 0 is unlimited.
+     * A source captured from the bypass network does not read the
+     * register file. Ports are shared by every issue queue and execute
+     * pipe of a core, usage is reset each cycle.
+     */
+    class RegisterFilePorts
+    {
+    public:
+        using PortCounts = std::array<uint32_t, core_types::N_REGFILES>;
+
+        RegisterFilePorts(const PortCounts & read_ports, const PortCounts & write_ports,
+                          const BypassNetwork & bypass) :
+            read_ports_(read_ports),
+            write_ports_(write_ports),
+            bypass_(bypass)
+        {
+        }
+
+        //! Reserve the read ports for the sources of inst issued to
+        //! consumer_pipe this cycle, nothing is reserved if a register
+        //! file is out of ports
+        bool reserveReads(const InstPtr & inst, const uint32_t consumer_pipe,
+                          const sparta::Clock::Cycle cycle)
+        {
+            newCycle_(cycle);
+            PortCounts reads{};
+            for (const auto & src : inst->getRenameData().getSourceList())
+            {
+                if ((src.rf == core_types::RF_INVALID) || src.is_x0
+                    || bypass_.isForwarded(src, consumer_pipe, cycle))
+                {
+                    continue;
+                }
+                ++reads[src.rf];
+            }
+            for (uint32_t rf = 0; rf < core_types::N_REGFILES; ++rf)
+            {
+                if (read_ports_[rf] == 0)
+                {
+                    continue;
+                }
+                // More sources than ports takes every port of the file
+                reads[rf] = std::min(reads[rf], read_ports_[rf]);
+                if (reads_used_[rf] + reads[rf] > read_ports_[rf])
+                {
+                    return false;
+                }
+            }
+            for (uint32_t rf = 0; rf < core_types::N_REGFILES; ++rf)
+            {
+                reads_used_[rf] += reads[rf];
+            }
+            return true;
+        }
+
+        //! Reserve a write port of rf this cycle
+        bool reserveWrite(const core_types::RegFile rf, const sparta::Clock::Cycle cycle)
+        {
+            newCycle_(cycle);
+            if ((write_ports_[rf] != 0) && (writes_used_[rf] == write_ports_[rf]))
+            {
+                return false;
+            }
+            ++writes_used_[rf];
+            return true;
+        }
+
+    private:
+
+        void newCycle_(const sparta::Clock::Cycle cycle)
+        {
+            if (cycle != usage_cycle_)
+            {
+                usage_cycle_ = cycle;
+                reads_used_.fill(0);
+                writes_used_.fill(0);
+            }
+        }
+
+        const PortCounts read_ports_;
+        const PortCounts write_ports_;
+        const BypassNetwork & bypass_;
+
+        sparta::Clock::Cycle usage_cycle_ = std::numeric_limits<sparta::Clock::Cycle>::max();
+        PortCounts reads_used_{};
+        PortCounts writes_used_{};
+    };
+}
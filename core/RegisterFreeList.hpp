@@ -0,0 +1,130 @@
+// <RegisterFreeList.hpp> -*- C++ -*-
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "sparta/utils/SpartaAssert.hpp"
+
+namespace olympia
+{
+    /**
+     * @file   RegisterFreeList.hpp
+     * @brief Bitmap free list of physical registers with reference counts
+     *
+     * A set bit marks a free physical register. Allocation takes the
+     * lowest free register (find first set), a group of registers is
+     * allocated a 64-bit word at a time. Each register has a packed
+     * reference counter, a register returns to the free list when its
+     * last reference is released.
+     */
+    class RegisterFreeList
+    {
+    public:
+        using RefCountType = uint16_t;
+
+        //! Size the free list, all registers free and unreferenced
+        void init(const uint32_t num_regs)
+        {
+            num_regs_ = num_regs;
+            num_free_ = num_regs;
+            free_bits_.assign((num_regs + BITS_PER_WORD - 1) / BITS_PER_WORD, ~uint64_t(0));
+            if (num_regs % BITS_PER_WORD) {
+                free_bits_.back() = (uint64_t(1) << (num_regs % BITS_PER_WORD)) - 1;
+            }
+            ref_counts_.assign(num_regs, 0);
+        }
+
+        //! Number of physical registers
+        uint32_t capacity() const { return num_regs_; }
+
+        //! Number of free physical registers
+        uint32_t size() const { return num_free_; }
+
+        bool empty() const { return num_free_ == 0; }
+
+        bool isFree(const uint32_t reg) const
+        {
+            return (free_bits_[reg / BITS_PER_WORD] >> (reg % BITS_PER_WORD)) & 1;
+        }
+
+        //! Take a specific free register, e.g. the initial ARF mappings
+        void claim(const uint32_t reg)
+        {
+            sparta_assert(isFree(reg), "Claiming physical register " << reg << " that is not free");
+            free_bits_[reg / BITS_PER_WORD] &= ~(uint64_t(1) << (reg % BITS_PER_WORD));
+            --num_free_;
+        }
+
+        //! Allocate the lowest free register
+        uint32_t allocate()
+        {
+            sparta_assert(num_free_ > 0, "Allocating from an empty free list");
+            for (uint32_t w = 0; w < free_bits_.size(); ++w)
+            {
+                if (free_bits_[w] != 0) {
+                    const uint32_t reg = w * BITS_PER_WORD + __builtin_ctzll(free_bits_[w]);
+                    free_bits_[w] &= free_bits_[w] - 1;
+                    --num_free_;
+                    return reg;
+                }
+            }
+            sparta_assert(false, "Free list count and bitmap out of sync");
+            return 0;
+        }
+
+        //! Allocate the lowest num free registers, appended to regs in
+        //! ascending order
+        template<class RegListType>
+        void allocate(uint32_t num, RegListType & regs)
+        {
+            sparta_assert(num <= num_free_, "Allocating " << num << " registers, "
+                          << num_free_ << " free");
+            num_free_ -= num;
+            for (uint32_t w = 0; (num > 0) && (w < free_bits_.size()); ++w)
+            {
+                uint64_t & word = free_bits_[w];
+                while ((num > 0) && (word != 0)) {
+                    regs.push_back(w * BITS_PER_WORD + __builtin_ctzll(word));
+                    word &= word - 1;
+                    --num;
+                }
+            }
+            sparta_assert(num == 0, "Free list count and bitmap out of sync");
+        }
+
+        //! Return a register to the free list
+        void free(const uint32_t reg)
+        {
+            sparta_assert(!isFree(reg), "Freeing physical register " << reg << " twice");
+            free_bits_[reg / BITS_PER_WORD] |= uint64_t(1) << (reg % BITS_PER_WORD);
+            ++num_free_;
+        }
+
+        RefCountType refCount(const uint32_t reg) const { return ref_counts_[reg]; }
+
+        void addRef(const uint32_t reg) { ++ref_counts_[reg]; }
+
+        //! Drop a reference, the register is freed with its last
+        //! reference. Returns true if it was freed.
+        bool release(const uint32_t reg)
+        {
+            sparta_assert(ref_counts_[reg] > 0,
+                          "Releasing physical register " << reg << " without references");
+            if (--ref_counts_[reg] == 0) {
+                free(reg);
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        static constexpr uint32_t BITS_PER_WORD = 64;
+
+        uint32_t num_regs_ = 0;
+        uint32_t num_free_ = 0;
+        std::vector<uint64_t>     free_bits_;
+        std::vector<RefCountType> ref_counts_;
+    };
+}
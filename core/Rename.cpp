@@ -23,8 +23,35 @@ namespace olympia
                    node->getClock(), getStatisticSet()),
         num_to_rename_per_cycle_(p->num_to_rename),
         rename_histogram_(*getStatisticSet(), "rename_histogram", "Rename Stage Histogram",
-                          [&p]() { std::vector<int> v(p->num_to_rename+1); std::iota(v.begin(), v.end(), 0); return v; }())
+                          [&p]() { std::vector<int> v(p->num_to_rename+1); std::iota(v.begin(), v.end(), 0); return v; }()),
+        num_threads_(olympia::coreutils::getNumThreads(node->getParent())),
+        checkpoint_recovery_(p->map_recovery_mode == "checkpoint"),
+        num_checkpoints_(p->num_checkpoints),
+        walk_recovery_width_(p->walk_recovery_width),
+        checkpoint_recovery_latency_(p->checkpoint_recovery_latency),
+        num_checkpoint_recoveries_(getStatisticSet(), "num_checkpoint_recoveries",
+                                   "Flushes recovered from a map table checkpoint",
+                                   sparta::Counter::COUNT_NORMAL),
+        num_walk_recoveries_(getStatisticSet(), "num_walk_recoveries",
+                             "Flushes recovered by walking the squashed instructions",
+                             sparta::Counter::COUNT_NORMAL),
+        map_recovery_cycles_(getStatisticSet(), "map_recovery_cycles",
+                             "Cycles renaming was blocked by map table recovery",
+                             sparta::Counter::COUNT_NORMAL),
+        move_elimination_(p->move_elimination),
+        num_eliminations_per_cycle_(p->num_eliminations_per_cycle),
+        num_moves_eliminated_(getStatisticSet(), "num_moves_eliminated",
+                              "Register moves eliminated at rename",
+                              sparta::Counter::COUNT_NORMAL),
+        num_zero_idioms_eliminated_(getStatisticSet(), "num_zero_idioms_eliminated",
+                                    "Zeroing idioms eliminated at rename",
+                                    sparta::Counter::COUNT_NORMAL)
     {
+        sparta_assert(checkpoint_recovery_ || (p->map_recovery_mode == "walk"),
+                      "Unknown map_recovery_mode: " << p->map_recovery_mode);
+        sparta_assert(!checkpoint_recovery_ || (num_checkpoints_ > 0),
+                      "Checkpoint map recovery needs at least one checkpoint");
+
         uop_queue_.enableCollection(node);
 
         // The path into the Rename block
@@ -39,34 +66,64 @@ namespace olympia
         in_rename_retire_ack_.registerConsumerHandler
                 (CREATE_SPARTA_HANDLER_WITH_DATA(Rename, getAckFromROB_, InstPtr));
         sparta::StartupEvent(node, CREATE_SPARTA_HANDLER(Rename, setupRename_));
+
+        map_table_.resize(num_threads_);
+        inst_queue_.resize(num_threads_);
+        checkpoints_.resize(num_threads_);
         auto setup_map = [this] (core_types::RegFile reg_file, const uint32_t num_renames) {
                         const uint32_t num_regs = 32;  // default risc-v ARF count
-                        sparta_assert(num_regs < num_renames); // ensure we have more renames than 32 because first 32 renames are allocated at the beginning
-                        // initialize the first 32 Float (31 for INT) regs, i.e x1 -> PRF1
+                        // ensure we have more renames than 32 per thread because the first 32 renames
+                        // of each thread are allocated at the beginning
+                        sparta_assert(num_regs * num_threads_ < num_renames,
+                                      "Not enough renames for " << num_threads_ << " threads");
+                        // initialize the first 32 Float (31 for INT) regs, i.e x1 -> PRF1,
+                        // thread t starting at PRF t*32
 
                         // for x0 for RF_INTEGER, we don't want to set a PRF for it because x0 is hardwired to 0
-                        uint32_t i = 0;
-                        if (reg_file == core_types::RegFile::RF_INTEGER){
-                            reference_counter_[reg_file].push_back(0);
-                            freelist_[reg_file].push(0);
-                            i = 1;
-                        }
-                        for(; i < num_regs; i++){
-                            map_table_[reg_file][i] = i;
-                            // for the first 32 Float (31 INT) registers, we mark their reference_counters 1, as they are the
-                            // current "valid" PRF for that ARF
-                            reference_counter_[reg_file].push_back(1);
-                        }
-                        for(uint32_t j = num_regs; j < num_renames; ++j) {
-                            freelist_[reg_file].push(j);
-                            reference_counter_[reg_file].push_back(0);
+                        freelist_[reg_file].init(num_renames);
+                        for(uint32_t tid = 0; tid < num_threads_; ++tid)
+                        {
+                            uint32_t i = 0;
+                            if (reg_file == core_types::RegFile::RF_INTEGER){
+                                // PRF t*32 stays free
+                                i = 1;
+                            }
+                            for(; i < num_regs; i++){
+                                const uint32_t prf = tid * num_regs + i;
+                                map_table_[tid][reg_file][i] = prf;
+                                // for the first 32 Float (31 INT) registers, we mark their reference counters 1, as they are the
+                                // current "valid" PRF for that ARF
+                                freelist_[reg_file].claim(prf);
+                                freelist_[reg_file].addRef(prf);
+                            }
                         }
                     };
 
         setup_map(core_types::RegFile::RF_INTEGER, p->num_integer_renames);
         setup_map(core_types::RegFile::RF_FLOAT,   p->num_float_renames);
+        setup_map(core_types::RegFile::RF_VECTOR,  p->num_vector_renames);
+
+        // Zeroing idioms map to the integer zero PRF, it is never freed
+        if (move_elimination_) {
+            freelist_[core_types::RegFile::RF_INTEGER].claim(ZERO_PRF);
+            freelist_[core_types::RegFile::RF_INTEGER].addRef(ZERO_PRF);
+        }
+
+        for(uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+        {
+            const int num_renames = freelist_[rf].capacity();
+            const int step = std::max(num_renames / 16, 1);
+            std::vector<int> buckets;
+            for(int b = 0; b < num_renames; b += step) {
+                buckets.emplace_back(b);
+            }
+            buckets.emplace_back(num_renames);
+            freelist_histograms_[rf].reset(new sparta::BasicHistogram<int>(
+                *getStatisticSet(), core_types::regfile_names[rf] + std::string("_freelist_histogram"),
+                std::string("Free ") + core_types::regfile_names[rf] + " renames histogram", buckets));
+        }
 
-        static_assert(core_types::RegFile::N_REGFILES == 2, "New RF type added, but Rename not updated");
+        static_assert(core_types::RegFile::N_REGFILES == 3, "New RF type added, but Rename not updated");
     }
 
     // Using the Rename factory, create the Scoreboards
@@ -99,16 +156,17 @@ namespace olympia
             auto sb_tn = sbs_tn->getChild(core_types::regfile_names[rf]);
             scoreboards_[rf] = sb_tn->getResourceAs<sparta::Scoreboard*>();
 
-            // Initialize 32 scoreboard resources,
+            // Initialize 32 scoreboard resources per thread,
             // all ready.
-            uint32_t reg = 0;
-            if(rf == core_types::RegFile::RF_INTEGER){
-                reg = 1;
-            }
-            constexpr uint32_t num_regs = 32;
             core_types::RegisterBitMask bits;
-            for(; reg < num_regs; ++reg) {
-                bits.set(reg);
+            for(const auto & map_table : map_table_) {
+                for(const auto prf : map_table[rf]) {
+                    bits.set(prf);
+                }
+            }
+            if(rf == core_types::RegFile::RF_INTEGER && !move_elimination_){
+                // x0 is never mapped
+                bits.reset(ZERO_PRF);
             }
             scoreboards_[rf]->set(bits);
         }
@@ -141,12 +199,9 @@ namespace olympia
             if (!is_x0)
             {
                 auto const & original_dest = inst_ptr->getRenameData().getOriginalDestination();
-                --reference_counter_[original_dest.rf][original_dest.val];
                 // free previous PRF mapping if no references from srcs, there should be a new dest mapping for the ARF -> PRF
                 // so we know it's free to be pushed to freelist if it has no other src references
-                if(reference_counter_[original_dest.rf][original_dest.val] <= 0){
-                    freelist_[original_dest.rf].push(original_dest.val);
-                }
+                freelist_[original_dest.rf].release(original_dest.val);
             }
         }
 
@@ -155,30 +210,33 @@ namespace olympia
         if(inst_ptr->isLoadStoreInst()){
             const auto & data_reg = inst_ptr->getRenameData().getDataReg();
             if(data_reg.field_id == mavis::InstMetaData::OperandFieldID::RS2 && data_reg.is_x0 != true){
-                --reference_counter_[data_reg.rf][data_reg.val];
-                if(reference_counter_[data_reg.rf][data_reg.val] <= 0){
-                    // freeing data register value, because it's not in the source list, so won't get caught below
-                    freelist_[data_reg.rf].push(data_reg.val);
-                }
+                // freeing data register value, because it's not in the source list, so won't get caught below
+                freelist_[data_reg.rf].release(data_reg.val);
             }
         }
         // freeing references to PRF
         for(const auto & src: srcs){
-            --reference_counter_[src.rf][src.val];
-            if(reference_counter_[src.rf][src.val] <= 0){
-                // freeing a register in the case where it still has references and has already been retired
-                // we wait until the last reference is retired to then free the prf
-                // any "valid" PRF that is the true mapping of an ARF will have a reference_counter of at least 1,
-                // and thus shouldn't be retired
-                freelist_[src.rf].push(src.val);
-            }
+            // freeing a register in the case where it still has references and has already been retired
+            // we wait until the last reference is retired to then free the prf
+            // any "valid" PRF that is the true mapping of an ARF will have a reference_counter of at least 1,
+            // and thus shouldn't be retired
+            freelist_[src.rf].release(src.val);
         }
+        // Release the checkpoint of a retiring branch
+        auto & checkpoints = checkpoints_[inst_ptr->getThreadID()];
+        if (!checkpoints.empty() &&
+            (checkpoints.front().branch->getUniqueID() == inst_ptr->getUniqueID()))
+        {
+            checkpoints.pop_front();
+        }
+
         // Instruction queue bookkeeping
-        if (SPARTA_EXPECT_TRUE(!inst_queue_.empty()))
+        auto & inst_queue = inst_queue_[inst_ptr->getThreadID()];
+        if (SPARTA_EXPECT_TRUE(!inst_queue.empty()))
         {
-            const auto & oldest_inst = inst_queue_.front();
+            const auto & oldest_inst = inst_queue.front();
             sparta_assert(oldest_inst->getUniqueID() == inst_ptr->getUniqueID(), "ROB and rename inst_queue out of sync");
-            inst_queue_.pop_front();
+            inst_queue.pop_front();
         }
         else
         {
@@ -195,109 +253,198 @@ namespace olympia
     void Rename::handleFlush_(const FlushManager::FlushingCriteria & criteria)
     {
         ILOG("Got a flush call for " << criteria);
-        // Restore the rename map, reference counters and freelist by walking through the inst_queue
-        while (inst_queue_.size())
+
+        // Only the flushing thread's rename state is recovered
+        auto & inst_queue  = inst_queue_[criteria.getThreadID()];
+        auto & checkpoints = checkpoints_[criteria.getThreadID()];
+        auto & map_table   = map_table_[criteria.getThreadID()];
+
+        // Squashed instructions, youngest first
+        std::vector<InstPtr> squashed;
+        while (inst_queue.size() && criteria.includedInFlush(inst_queue.back()))
         {
-            const auto & inst_ptr = inst_queue_.back();
-            if (!criteria.includedInFlush(inst_ptr))
-            {
-                break;
-            }
-            else
+            squashed.emplace_back(inst_queue.back());
+            inst_queue.pop_back();
+        }
+
+        // Drop the checkpoints of squashed branches. If the youngest
+        // surviving instruction is a branch, its checkpoint is the map
+        // table to return to.
+        while (!checkpoints.empty() && criteria.includedInFlush(checkpoints.back().branch))
+        {
+            checkpoints.pop_back();
+        }
+        const bool restore_checkpoint = !squashed.empty() && !checkpoints.empty() &&
+            !inst_queue.empty() && (checkpoints.back().branch.get() == inst_queue.back().get());
+        if (restore_checkpoint)
+        {
+            map_table = checkpoints.back().map_table;
+            ILOG("restored map table checkpoint of " << checkpoints.back().branch);
+        }
+
+        // Release the renames and source references of the squashed
+        // instructions. Without a checkpoint also restore the rename map.
+        for (const auto & inst_ptr : squashed)
+        {
+            auto const & dests = inst_ptr->getDestOpInfoList();
+            for (const auto & dest : dests)
             {
-                auto const & dests = inst_ptr->getDestOpInfoList();
-                for (const auto & dest : dests)
+                // restore rename table following a flush
+                const auto rf  = olympia::coreutils::determineRegisterFile(dest);
+                const auto num = dest.field_value;
+                const bool is_x0 = (num == 0 && rf == core_types::RF_INTEGER);
+                if (!is_x0)
                 {
-                    // restore rename table following a flush
-                    const auto rf  = olympia::coreutils::determineRegisterFile(dest);
-                    const auto num = dest.field_value;
-                    const bool is_x0 = (num == 0 && rf == core_types::RF_INTEGER);
-                    if (!is_x0)
+                    if (!restore_checkpoint)
                     {
                         auto const & original_dest = inst_ptr->getRenameData().getOriginalDestination();
-                        map_table_[rf][num] = original_dest.val;
-
-                        // free renamed PRF mapping when reference counter reaches zero
-                        auto const & renamed_dest = inst_ptr->getRenameData().getDestination();
-                        --reference_counter_[renamed_dest.rf][renamed_dest.val];
-                        if(reference_counter_[renamed_dest.rf][renamed_dest.val] <= 0){
-                            freelist_[renamed_dest.rf].push(renamed_dest.val);
-                        }
+                        map_table[rf][num] = original_dest.val;
                     }
+
+                    // free renamed PRF mapping when reference counter reaches zero
+                    auto const & renamed_dest = inst_ptr->getRenameData().getDestination();
+                    freelist_[renamed_dest.rf].release(renamed_dest.val);
                 }
+            }
 
-                const auto & srcs = inst_ptr->getRenameData().getSourceList();
-                // decrement reference to data register
-                if(inst_ptr->isLoadStoreInst()){
-                    const auto & data_reg = inst_ptr->getRenameData().getDataReg();
-                    if(data_reg.field_id == mavis::InstMetaData::OperandFieldID::RS2 && data_reg.is_x0 != true){
-                        --reference_counter_[data_reg.rf][data_reg.val];
-                        if(reference_counter_[data_reg.rf][data_reg.val] <= 0){
-                            // freeing data register value, because it's not in the source list, so won't get caught below
-                            freelist_[data_reg.rf].push(data_reg.val);
-                        }
-                    }
+            const auto & srcs = inst_ptr->getRenameData().getSourceList();
+            // decrement reference to data register
+            if(inst_ptr->isLoadStoreInst()){
+                const auto & data_reg = inst_ptr->getRenameData().getDataReg();
+                if(data_reg.field_id == mavis::InstMetaData::OperandFieldID::RS2 && data_reg.is_x0 != true){
+                    // freeing data register value, because it's not in the source list, so won't get caught below
+                    freelist_[data_reg.rf].release(data_reg.val);
                 }
-                // freeing references to PRF
-                for(const auto & src: srcs){
-                    --reference_counter_[src.rf][src.val];
-                    if(reference_counter_[src.rf][src.val] <= 0){
-                        // freeing a register in the case where it still has references and has already been retired
-                        // we wait until the last reference is retired to then free the prf
-                        // any "valid" PRF that is the true mapping of an ARF will have a reference_counter of at least 1,
-                        // and thus shouldn't be retired
-                        freelist_[src.rf].push(src.val);
-                    }
+            }
+            // freeing references to PRF
+            for(const auto & src: srcs){
+                // freeing a register in the case where it still has references and has already been retired
+                // we wait until the last reference is retired to then free the prf
+                // any "valid" PRF that is the true mapping of an ARF will have a reference_counter of at least 1,
+                // and thus shouldn't be retired
+                freelist_[src.rf].release(src.val);
+            }
+        }
+
+        // Charge the recovery latency, renaming waits for it
+        if (!squashed.empty())
+        {
+            uint32_t recovery_cycles = 0;
+            if (restore_checkpoint) {
+                recovery_cycles = checkpoint_recovery_latency_;
+                ++num_checkpoint_recoveries_;
+            }
+            else {
+                if (walk_recovery_width_ > 0) {
+                    recovery_cycles = (squashed.size() + walk_recovery_width_ - 1) / walk_recovery_width_;
                 }
-                inst_queue_.pop_back();
+                ++num_walk_recoveries_;
+            }
+            recovery_done_cycle_ = getClock()->currentCycle() + recovery_cycles;
+            map_recovery_cycles_ += recovery_cycles;
+        }
+
+        // Return the renames reserved for a group that was not renamed
+        for(uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf)
+        {
+            for(const auto prf : group_dests_[rf]) {
+                freelist_[rf].free(prf);
             }
+            group_dests_[rf].clear();
         }
+        num_to_rename_ = 0;
 
         current_stall_ = NO_DECODE_INSTS;
 
-        // Clean up buffers
+        // Clean up buffers, keeping the other threads' instructions
+        std::vector<InstPtr> survivors;
+        for (const auto & inst_ptr : uop_queue_)
+        {
+            if (!criteria.includedInFlush(inst_ptr)) {
+                survivors.emplace_back(inst_ptr);
+            }
+        }
         uop_queue_regcount_data_.clear();
-        out_uop_queue_credits_.send(uop_queue_.size());
+        out_uop_queue_credits_.send(uop_queue_.size() - survivors.size());
         uop_queue_.clear();
+        for (const auto & inst_ptr : survivors) {
+            appendUop_(inst_ptr);
+        }
+        if (credits_dispatch_ > 0 && (uop_queue_.size() > 0)) {
+            ev_schedule_rename_.schedule();
+        }
     }
 
     void Rename::decodedInstructions_(const InstGroupPtr & insts)
     {
         sparta_assert(in_uop_queue_append_.dataReceived());
 
+        for(auto & i : *insts) {
+            appendUop_(i);
+        }
+
+        if(credits_dispatch_ > 0) {
+            ev_schedule_rename_.schedule();
+        }
+    }
+
+    void Rename::appendUop_(const InstPtr & inst)
+    {
         RegCountData current_counts;
         if(!uop_queue_regcount_data_.empty()){
             // if we have entries, use the most recent entered instruction counts
             current_counts = uop_queue_regcount_data_.back();
         }
-        for(auto & i : *insts) {
-            // create an index count for each instruction entered
-            const auto & dests = i->getDestOpInfoList();
-            if(dests.size() > 0){
-                sparta_assert(dests.size() == 1); // we should only have one destination
-                const auto rf = olympia::coreutils::determineRegisterFile(dests[0]);
-                const auto num = dests[0].field_value;
-                const bool is_x0 = (num == 0 && rf == core_types::RF_INTEGER);
-                // if dest is x0, we don't need to count it towards cumulative register count
-                if(!is_x0){
-                    current_counts.cumulative_reg_counts[rf]++;
-                }
+        // create an index count for each instruction entered
+        const auto & dests = inst->getDestOpInfoList();
+        if(dests.size() > 0){
+            sparta_assert(dests.size() == 1); // we should only have one destination
+            const auto rf = olympia::coreutils::determineRegisterFile(dests[0]);
+            const auto num = dests[0].field_value;
+            const bool is_x0 = (num == 0 && rf == core_types::RF_INTEGER);
+            // if dest is x0, we don't need to count it towards cumulative register count
+            if(!is_x0){
+                current_counts.cumulative_reg_counts[rf]++;
             }
-            uop_queue_.push(i);
-            uop_queue_regcount_data_.push_back(current_counts);
-        }
-
-        if(credits_dispatch_ > 0) {
-            ev_schedule_rename_.schedule();
         }
+        uop_queue_.push(inst);
+        uop_queue_regcount_data_.push_back(current_counts);
     }
     void Rename::scheduleRenaming_()
     {
         current_stall_ = StallReason::NOT_STALLED;
 
+        // Wait for the map table to be recovered from a flush
+        const uint64_t current_cycle = getClock()->currentCycle();
+        if(current_cycle < recovery_done_cycle_)
+        {
+            current_stall_ = StallReason::MAP_RECOVERY;
+            num_to_rename_ = 0;
+            ILOG("current stall: " << current_stall_);
+            rename_histogram_.addValue((int) num_to_rename_);
+            ev_schedule_rename_.schedule(recovery_done_cycle_ - current_cycle);
+            return;
+        }
+
+        for(uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf) {
+            freelist_histograms_[rf]->addValue((int) freelist_[rf].size());
+        }
+
         // If we have credits from dispatch, schedule a rename session this cycle
         uint32_t num_rename = std::min(uop_queue_.size(), num_to_rename_per_cycle_);
         num_rename = std::min(credits_dispatch_, num_rename);
+        if(checkpoint_recovery_ && (num_rename > 0))
+        {
+            num_rename = checkpointRenameLimit_(num_rename);
+            if(num_rename == 0) {
+                // Waits for a branch to retire
+                current_stall_ = StallReason::NO_CHECKPOINTS;
+                num_to_rename_ = 0;
+                ILOG("current stall: " << current_stall_);
+                rename_histogram_.addValue((int) num_to_rename_);
+                return;
+            }
+        }
         if(credits_dispatch_ > 0)
         {
             RegCountData count_subtract;
@@ -328,6 +475,10 @@ namespace olympia
             {
                 count_subtract = uop_queue_regcount_data_.front();
                 uop_queue_regcount_data_.pop_front();
+                // reserve the destination renames of the whole group
+                for(uint32_t j = 0; j < core_types::RegFile::N_REGFILES; ++j) {
+                    freelist_[j].allocate(count_subtract.cumulative_reg_counts[j], group_dests_[j]);
+                }
                 for(uint32_t i = 0; i < uop_queue_regcount_data_.size(); ++i){
                     for(uint32_t j = 0; j < core_types::RegFile::N_REGFILES; ++j)
                     {
@@ -350,6 +501,149 @@ namespace olympia
 
         rename_histogram_.addValue((int) num_to_rename_);
     }
+    uint32_t Rename::checkpointRenameLimit_(uint32_t num_rename) const
+    {
+        std::vector<uint32_t> free_checkpoints(num_threads_);
+        for(uint32_t tid = 0; tid < num_threads_; ++tid) {
+            free_checkpoints[tid] = num_checkpoints_ - checkpoints_[tid].size();
+        }
+        for(uint32_t i = 0; i < num_rename; ++i)
+        {
+            const auto & inst = uop_queue_.read(i);
+            if(inst->isBranch()) {
+                if(free_checkpoints[inst->getThreadID()] == 0) {
+                    return i;
+                }
+                --free_checkpoints[inst->getThreadID()];
+            }
+        }
+        return num_rename;
+    }
+
+    Rename::ElimIdiom Rename::getElimIdiom_(const InstPtr & inst)
+    {
+        const auto uid = inst->getMavisUid();
+        auto itr = elim_idioms_.find(uid);
+        if(itr == elim_idioms_.end())
+        {
+            static const std::map<std::string, ElimIdiom> idiom_mnemonics = {
+                {"addi",    ElimIdiom::ADDI},      {"mv",      ElimIdiom::MOVE},
+                {"c.mv",    ElimIdiom::MOVE},      {"add",     ElimIdiom::ADD},
+                {"xor",     ElimIdiom::SAME_SRCS}, {"sub",     ElimIdiom::SAME_SRCS},
+                {"fsgnj.s", ElimIdiom::FMOVE},     {"fsgnj.d", ElimIdiom::FMOVE},
+                {"fmv.s",   ElimIdiom::FMOVE},     {"fmv.d",   ElimIdiom::FMOVE},
+                {"c.li",    ElimIdiom::LI}};
+            const auto mnemonic_itr = idiom_mnemonics.find(inst->getMnemonic());
+            const auto idiom = (mnemonic_itr == idiom_mnemonics.end()) ?
+                ElimIdiom::NONE : mnemonic_itr->second;
+            itr = elim_idioms_.emplace(uid, idiom).first;
+        }
+        return itr->second;
+    }
+
+    bool Rename::eliminateInst_(const InstPtr & inst)
+    {
+        const auto idiom = getElimIdiom_(inst);
+        if((idiom == ElimIdiom::NONE) || inst->isCracked()) {
+            return false;
+        }
+
+        const auto & dests = inst->getDestOpInfoList();
+        if(dests.size() != 1) {
+            return false;
+        }
+        const auto & dest = dests[0];
+        const auto rf  = olympia::coreutils::determineRegisterFile(dest);
+        const auto num = dest.field_value;
+        if(num == 0 && rf == core_types::RF_INTEGER) {
+            return false;
+        }
+
+        // Find the register moved, nullptr for a zeroing idiom
+        const auto & srcs = inst->getSourceOpInfoList();
+        const bool same_srcs = (srcs.size() == 2) &&
+            (srcs[0].field_value == srcs[1].field_value);
+        const auto is_x0 = [](const auto & src) {
+            return (src.field_value == 0) &&
+                (olympia::coreutils::determineRegisterFile(src) == core_types::RF_INTEGER);
+        };
+        const Inst::OpInfoList::value_type * move_src = nullptr;
+        switch(idiom)
+        {
+            case ElimIdiom::ADDI:
+                if((srcs.size() != 1) || (inst->getImmediate() != 0)) {
+                    return false;
+                }
+                move_src = &srcs[0];
+                break;
+            case ElimIdiom::MOVE:
+                if(srcs.size() != 1) {
+                    return false;
+                }
+                move_src = &srcs[0];
+                break;
+            case ElimIdiom::ADD:
+                if((srcs.size() != 2) || (!is_x0(srcs[0]) && !is_x0(srcs[1]))) {
+                    return false;
+                }
+                move_src = is_x0(srcs[0]) ? &srcs[1] : &srcs[0];
+                break;
+            case ElimIdiom::SAME_SRCS:
+                if(!same_srcs) {
+                    return false;
+                }
+                break;
+            case ElimIdiom::FMOVE:
+                if(!same_srcs) {
+                    return false;
+                }
+                move_src = &srcs[0];
+                break;
+            case ElimIdiom::LI:
+                if(!inst->hasImmediate() || (inst->getImmediate() != 0)) {
+                    return false;
+                }
+                break;
+            case ElimIdiom::NONE:
+                return false;
+        }
+
+        // Moves from x0 are zeroing idioms too
+        if(move_src && is_x0(*move_src)) {
+            move_src = nullptr;
+        }
+        auto & map_table = map_table_[inst->getThreadID()];
+        uint32_t prf = ZERO_PRF;
+        if(move_src) {
+            if(olympia::coreutils::determineRegisterFile(*move_src) != rf) {
+                return false;
+            }
+            prf = map_table[rf][move_src->field_value];
+        }
+        else if(rf != core_types::RF_INTEGER) {
+            // Only the integer register file has a zero PRF
+            return false;
+        }
+
+        // Alias the destination, the reference marks the new mapping
+        // "valid" like an allocated destination. The scoreboard is left
+        // alone, consumers wait on the aliased PRF.
+        inst->getRenameData().setOriginalDestination({map_table[rf][num], rf, dest.field_id});
+        inst->getRenameData().setDestination({prf, rf, dest.field_id});
+        map_table[rf][num] = prf;
+        freelist_[rf].addRef(prf);
+        inst->setEliminated(true);
+
+        if(move_src) {
+            ++num_moves_eliminated_;
+        }
+        else {
+            ++num_zero_idioms_eliminated_;
+        }
+        ILOG("\teliminated, destination aliased to PRF " << prf << " for '" << rf << "'");
+        return true;
+    }
+
     void Rename::renameInstructions_()
     {
         if(num_to_rename_ > 0)
@@ -357,13 +651,27 @@ namespace olympia
             // Pick instructions from uop queue to rename
             InstGroupPtr insts = sparta::allocate_sparta_shared_pointer<InstGroup>(instgroup_allocator);
 
+            uint32_t num_eliminated = 0;
             for(uint32_t i = 0; i < num_to_rename_; ++i)
             {
                 // Pick the oldest
                 const auto & renaming_inst = uop_queue_.read(0);
+                auto & map_table = map_table_[renaming_inst->getThreadID()];
+                auto & checkpoints = checkpoints_[renaming_inst->getThreadID()];
+                auto & inst_queue = inst_queue_[renaming_inst->getThreadID()];
                 renaming_inst->setStatus(Inst::Status::RENAMED);
                 ILOG("sending inst to dispatch: " << renaming_inst);
 
+                if(move_elimination_ && (num_eliminated < num_eliminations_per_cycle_)
+                   && eliminateInst_(renaming_inst))
+                {
+                    ++num_eliminated;
+                    insts->emplace_back(renaming_inst);
+                    inst_queue.emplace_back(renaming_inst);
+                    uop_queue_.pop();
+                    continue;
+                }
+
                 const auto & srcs = renaming_inst->getSourceOpInfoList();
                 const auto & dests = renaming_inst->getDestOpInfoList();
                 for(const auto & src : srcs)
@@ -381,14 +689,15 @@ namespace olympia
                         continue;
                     }
                     // we check for load/store separately because address operand
-                    // is always integer
-                    else if(renaming_inst->isLoadStoreInst()) {
+                    // is always integer. Vector loads/stores rename every source
+                    // in its own register file, the LSU checks them all
+                    else if(renaming_inst->isLoadStoreInst() && !renaming_inst->isVector()) {
                         // check for data operand existing based on RS2 existence
                         // store data register info separately
                         if(src.field_id == mavis::InstMetaData::OperandFieldID::RS2) {
                             auto & bitmask = renaming_inst->getDataRegisterBitMask(rf);
-                            const uint32_t prf = map_table_[rf][num];
-                            reference_counter_[rf][prf]++;
+                            const uint32_t prf = map_table[rf][num];
+                            freelist_[rf].addRef(prf);
                             renaming_inst->getRenameData().setDataReg({prf, rf, src.field_id, is_x0});
                             bitmask.set(prf);
 
@@ -400,8 +709,8 @@ namespace olympia
                             // address is always INTEGER
                             const auto addr_rf  = core_types::RF_INTEGER;
                             auto & bitmask = renaming_inst->getSrcRegisterBitMask(addr_rf);
-                            const uint32_t prf = map_table_[addr_rf][num];
-                            reference_counter_[addr_rf][prf]++;
+                            const uint32_t prf = map_table[addr_rf][num];
+                            freelist_[addr_rf].addRef(prf);
                             renaming_inst->getRenameData().setSource({prf, addr_rf, src.field_id});
                             bitmask.set(prf);
 
@@ -412,8 +721,8 @@ namespace olympia
                     }
                     else {
                         auto & bitmask = renaming_inst->getSrcRegisterBitMask(rf);
-                        const uint32_t prf = map_table_[rf][num];
-                        reference_counter_[rf][prf]++;
+                        const uint32_t prf = map_table[rf][num];
+                        freelist_[rf].addRef(prf);
                         renaming_inst->getRenameData().setSource({prf, rf, src.field_id});
                         bitmask.set(prf);
 
@@ -432,17 +741,17 @@ namespace olympia
                     }
                     else{
                         auto & bitmask = renaming_inst->getDestRegisterBitMask(rf);
-                        const uint32_t prf = freelist_[rf].front();
-                        freelist_[rf].pop();
-                        renaming_inst->getRenameData().setOriginalDestination({map_table_[rf][num], rf, dest.field_id});
+                        const uint32_t prf = group_dests_[rf].front();
+                        group_dests_[rf].pop_front();
+                        renaming_inst->getRenameData().setOriginalDestination({map_table[rf][num], rf, dest.field_id});
                         renaming_inst->getRenameData().setDestination({prf, rf, dest.field_id});
-                        map_table_[rf][num] = prf;
-                        // we increase reference_counter_ for destinations to mark them as "valid",
-                        // so the PRF in the reference_counter_ should have a value of 1
+                        map_table[rf][num] = prf;
+                        // we increase the reference counter for destinations to mark them as "valid",
+                        // so the PRF reference counter should have a value of 1
                         // once a PRF reference_counter goes to 0, we know that the PRF isn't the "valid"
                         // PRF for that ARF anymore and there are no sources referring to it
                         // so we can push it to freelist
-                        reference_counter_[rf][prf]++;
+                        freelist_[rf].addRef(prf);
                         bitmask.set(prf);
                         // clear scoreboard for the PRF we are allocating
                         scoreboards_[rf]->clearBits(bitmask);
@@ -451,12 +760,33 @@ namespace olympia
                             << " for '" << rf << "' scoreboard");
                     }
                 }
+                // Checkpoint the map table after renaming a branch
+                if(checkpoint_recovery_ && renaming_inst->isBranch())
+                {
+                    sparta_assert(checkpoints.size() < num_checkpoints_,
+                                  "Renaming a branch without a free checkpoint: " << renaming_inst);
+                    checkpoints.emplace_back();
+                    checkpoints.back().branch = renaming_inst;
+                    checkpoints.back().map_table = map_table;
+                    ILOG("\tcheckpoint " << checkpoints.size() << " taken");
+                }
+
                 // Remove it from uop queue
                 insts->emplace_back(renaming_inst);
-                inst_queue_.emplace_back(renaming_inst);
+                inst_queue.emplace_back(renaming_inst);
                 uop_queue_.pop();
             }
 
+            // Eliminated instructions leave reserved renames unused
+            for(uint32_t rf = 0; rf < core_types::RegFile::N_REGFILES; ++rf) {
+                sparta_assert(group_dests_[rf].size() <= num_eliminated,
+                              "Reserved renames left over after renaming a group");
+                for(const auto prf : group_dests_[rf]) {
+                    freelist_[rf].free(prf);
+                }
+                group_dests_[rf].clear();
+            }
+
             // Send insts to dispatch
             out_dispatch_queue_write_.send(insts);
             credits_dispatch_ -= num_to_rename_;
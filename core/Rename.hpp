@@ -3,7 +3,12 @@
 
 #pragma once
 
+#include <array>
+#include <deque>
+#include <memory>
+#include <unordered_map>
 #include <string>
+#include <vector>
 
 #include "sparta/ports/DataPort.hpp"
 #include "sparta/events/UniqueEvent.hpp"
@@ -20,6 +25,7 @@
 #include "CoreTypes.hpp"
 #include "FlushManager.hpp"
 #include "InstGroup.hpp"
+#include "RegisterFreeList.hpp"
 
 namespace olympia
 {
@@ -48,6 +54,20 @@ namespace olympia
             PARAMETER(uint32_t, rename_queue_depth, 10, "Number of instructions queued for rename")
             PARAMETER(uint32_t, num_integer_renames, 128, "Number of integer renames")
             PARAMETER(uint32_t, num_float_renames,   128, "Number of float renames")
+            PARAMETER(uint32_t, num_vector_renames,  64, "Number of vector renames")
+            PARAMETER(std::string, map_recovery_mode, "walk",
+                      "Map table recovery on a flush: 'walk' the squashed instructions or "
+                      "restore a 'checkpoint' taken at the youngest surviving branch")
+            PARAMETER(uint32_t, num_checkpoints,       8,
+                      "Map table checkpoints per thread, checkpoint mode. Renaming a branch stalls when none are free")
+            PARAMETER(uint32_t, walk_recovery_width,   0,
+                      "Squashed instructions restored per cycle by a walk, 0 is no recovery latency")
+            PARAMETER(uint32_t, checkpoint_recovery_latency, 1,
+                      "Cycles to restore the map table from a checkpoint")
+            PARAMETER(bool,     move_elimination,      false,
+                      "Eliminate register moves and integer zeroing idioms at rename")
+            PARAMETER(uint32_t, num_eliminations_per_cycle, 2,
+                      "Max moves and zeroing idioms eliminated per cycle")
         };
 
         /**
@@ -89,13 +109,17 @@ namespace olympia
         Scoreboards scoreboards_;
         // histogram counter for number of renames each time scheduleRenaming_ is called
         sparta::BasicHistogram<int> rename_histogram_;
-        // map of ARF -> PRF
-        uint32_t map_table_[core_types::N_REGFILES][32];
-
-        // reference counter for PRF
-        std::array<std::vector<int32_t>, core_types::N_REGFILES> reference_counter_;
-        // list of free PRF that are available to map
-        std::queue<uint32_t> freelist_[core_types::N_REGFILES];
+        // map of ARF -> PRF, one per hardware thread
+        using MapTable = std::array<std::array<uint32_t, 32>, core_types::N_REGFILES>;
+        std::vector<MapTable> map_table_;
+        const uint32_t num_threads_;
+
+        // free PRF bitmap and reference counter for PRF
+        std::array<RegisterFreeList, core_types::N_REGFILES> freelist_;
+        // destination PRFs reserved by scheduleRenaming_ for the rename group
+        std::array<std::deque<uint32_t>, core_types::N_REGFILES> group_dests_;
+        // histogram of free PRFs each time scheduleRenaming_ is called
+        std::array<std::unique_ptr<sparta::BasicHistogram<int>>, core_types::N_REGFILES> freelist_histograms_;
         // used to track current number of each type of RF instruction at each
         // given index in the uop_queue_
         struct RegCountData{
@@ -104,8 +128,51 @@ namespace olympia
         std::deque<RegCountData> uop_queue_regcount_data_;
 
         // Used to track inflight instructions for the purpose of recovering
-        // the rename data structures
-        std::deque<InstPtr> inst_queue_;
+        // the rename data structures, per thread
+        std::vector<std::deque<InstPtr>> inst_queue_;
+
+        // Map table checkpoints, taken after renaming a branch and
+        // released when the branch retires or is flushed. Oldest first,
+        // per thread.
+        struct MapCheckpoint {
+            InstPtr  branch;
+            MapTable map_table;
+        };
+        std::vector<std::deque<MapCheckpoint>> checkpoints_;
+
+        // Map recovery configuration
+        const bool     checkpoint_recovery_;
+        const uint32_t num_checkpoints_;
+        const uint32_t walk_recovery_width_;
+        const uint32_t checkpoint_recovery_latency_;
+
+        // Renaming is blocked until this cycle while the map table is recovered
+        uint64_t recovery_done_cycle_ = 0;
+
+        sparta::Counter num_checkpoint_recoveries_;
+        sparta::Counter num_walk_recoveries_;
+        sparta::Counter map_recovery_cycles_;
+
+        // Move and zeroing idiom elimination. Moves alias the destination
+        // to the source PRF, integer zeroing idioms to ZERO_PRF, which is
+        // reserved and always ready when elimination is enabled.
+        enum class ElimIdiom {
+            NONE,
+            ADDI,       // addi rd, rs, 0 (mv) or addi rd, x0, 0 (li)
+            MOVE,       // c.mv rd, rs
+            ADD,        // add rd, rs, x0 or add rd, x0, rs
+            SAME_SRCS,  // xor/sub rd, rs, rs
+            FMOVE,      // fsgnj.[sd] rd, rs, rs (fmv)
+            LI          // c.li rd, 0
+        };
+        static constexpr uint32_t ZERO_PRF = 0;
+        const bool     move_elimination_;
+        const uint32_t num_eliminations_per_cycle_;
+        // idiom of each Mavis UID, classified by mnemonic on first sight
+        std::unordered_map<mavis::InstructionUniqueID, ElimIdiom> elim_idioms_;
+
+        sparta::Counter num_moves_eliminated_;
+        sparta::Counter num_zero_idioms_eliminated_;
 
 
         ///////////////////////////////////////////////////////////////////////
@@ -114,6 +181,8 @@ namespace olympia
             NO_DECODE_INSTS,     // No insts from Decode
             NO_DISPATCH_CREDITS, // No credits from Dispatch
             NO_RENAMES,          // Out of renames
+            NO_CHECKPOINTS,      // Out of map table checkpoints
+            MAP_RECOVERY,        // Map table recovery after a flush
             NOT_STALLED,         // Made forward progress (dipatched
                                  // all instructions or no
                                  // instructions)
@@ -135,6 +204,12 @@ namespace olympia
                 sparta::CycleCounter(getStatisticSet(), "stall_no_renames",
                                      "No Renames",
                                      sparta::Counter::COUNT_NORMAL, getClock()),
+                sparta::CycleCounter(getStatisticSet(), "stall_no_checkpoints",
+                                     "No Map Table Checkpoints",
+                                     sparta::Counter::COUNT_NORMAL, getClock()),
+                sparta::CycleCounter(getStatisticSet(), "stall_map_recovery",
+                                     "Map Table Recovery",
+                                     sparta::Counter::COUNT_NORMAL, getClock()),
                 sparta::CycleCounter(getStatisticSet(), "stall_not_stalled",
                                      "Rename not stalled, all instructions renamed",
                                      sparta::Counter::COUNT_NORMAL, getClock())
@@ -149,6 +224,9 @@ namespace olympia
         //! Process new instructions coming in from decode
         void decodedInstructions_(const InstGroupPtr &);
 
+        //! Append an instruction to the uop queue and its rename counts
+        void appendUop_(const InstPtr &);
+
         //! Schedule renaming if there are enough PRFs in the freelist_
         void scheduleRenaming_();
 
@@ -158,6 +236,17 @@ namespace olympia
         //! Flush instructions.
         void handleFlush_(const FlushManager::FlushingCriteria & criteria);
 
+        //! Number of the next num_rename uop queue entries that fit in
+        //! the free map table checkpoints
+        uint32_t checkpointRenameLimit_(uint32_t num_rename) const;
+
+        //! Elimination idiom of an instruction's Mavis UID
+        ElimIdiom getElimIdiom_(const InstPtr &);
+
+        //! Rename a move or zeroing idiom by aliasing its destination,
+        //! returns false if the instruction must execute
+        bool eliminateInst_(const InstPtr &);
+
         // Get Retired Instructions
         void getAckFromROB_(const InstPtr &);
 
@@ -179,6 +268,12 @@ namespace olympia
             case Rename::StallReason::NO_RENAMES:
                 os << "NO_RENAMES";
                 break;
+            case Rename::StallReason::NO_CHECKPOINTS:
+                os << "NO_CHECKPOINTS";
+                break;
+            case Rename::StallReason::MAP_RECOVERY:
+                os << "MAP_RECOVERY";
+                break;
             case Rename::StallReason::NOT_STALLED:
                 os << "NOT_STALLED";
                 break;
@@ -0,0 +1,379 @@
+// HEADER PLACEHOLDER
+// contact Jeff Nye, jeffnye-gh
+//
+//! \file FusionBench.cpp  fusion group matcher micro-benchmarks
+//!
+//! Measures the cost per decoded instruction of the structures used
+//! to match fusion groups against the decoded UID stream:
+//!
+//!   matchGroups   the Decode matcher, fusion::matchGroups()
+//!   hcache        fusion::HCache construction alone, the hashing step
+//!   radixtrie     RadixTrie<4> membership search of the segment hashes
+//!
+//! The group sets and the UID stream are synthetic. Group counts are
+//! swept from 16 to 4096 by default. Results are emitted as JSON.
+#include "fusion/FieldExtractor.hpp"
+#include "fusion/FusionGroup.hpp"
+#include "fusion/FusionMatch.hpp"
+#include "fusion/FusionTypes.hpp"
+#include "fusion/HCache.hpp"
+#include "fusion/MachineInfo.hpp"
+#include "fusion/RadixTrie.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    using FusionGroupType = fusion::FusionGroup<MachineInfo, FieldExtractor>;
+    using FusionGroupContainerType = std::unordered_map<fusion::HashType, FusionGroupType>;
+    using Clock = std::chrono::steady_clock;
+
+    //! \brief benchmark knobs, see usage()
+    struct BenchOptions
+    {
+        uint64_t num_insts = 1 << 20;
+        uint32_t decode_width = 8;
+        uint32_t max_group_size = 4;
+        uint32_t num_uids = 256;
+        double fusion_density = 0.25;
+        uint32_t seed = 1;
+        std::vector<uint32_t> group_counts{16, 64, 256, 1024, 4096};
+        std::string output;
+    };
+
+    //! \brief one row of the results
+    struct BenchResult
+    {
+        std::string matcher;
+        uint32_t num_groups;
+        double ns_per_inst;
+        uint64_t hits;
+    };
+
+    void usage(const char* prog)
+    {
+        std::cout << "usage: " << prog << " [options]\n"
+                  << "  --insts N           decoded instructions per measurement\n"
+                  << "  --decode-width N    UIDs matched per decode group\n"
+                  << "  --max-group-size N  longest synthetic fusion group\n"
+                  << "  --uids N            size of the synthetic UID alphabet\n"
+                  << "  --density F         fraction of the stream seeded with groups\n"
+                  << "  --groups N,N,...    group set sizes to sweep\n"
+                  << "  --seed N            random seed\n"
+                  << "  --output FILE       JSON results file, default stdout\n";
+    }
+
+    std::vector<uint32_t> parseList(const std::string & arg)
+    {
+        std::vector<uint32_t> values;
+        size_t pos = 0;
+        while (pos < arg.size())
+        {
+            const size_t next = arg.find(',', pos);
+            values.push_back(std::stoul(arg.substr(pos, next - pos)));
+            pos = (next == std::string::npos) ? arg.size() : next + 1;
+        }
+        return values;
+    }
+
+    BenchOptions parseOptions(int ac, char** av)
+    {
+        BenchOptions opts;
+        for (int i = 1; i < ac; ++i)
+        {
+            const std::string arg = av[i];
+            if (arg == "-h" || arg == "--help")
+            {
+                usage(av[0]);
+                std::exit(0);
+            }
+            if (i + 1 >= ac)
+            {
+                usage(av[0]);
+                std::exit(1);
+            }
+            const std::string val = av[++i];
+            if (arg == "--insts")
+            {
+                opts.num_insts = std::stoull(val);
+            }
+            else if (arg == "--decode-width")
+            {
+                opts.decode_width = std::stoul(val);
+            }
+            else if (arg == "--max-group-size")
+            {
+                opts.max_group_size = std::stoul(val);
+            }
+            else if (arg == "--uids")
+            {
+                opts.num_uids = std::stoul(val);
+            }
+            else if (arg == "--density")
+            {
+                opts.fusion_density = std::stod(val);
+            }
+            else if (arg == "--groups")
+            {
+                opts.group_counts = parseList(val);
+            }
+            else if (arg == "--seed")
+            {
+                opts.seed = std::stoul(val);
+            }
+            else if (arg == "--output")
+            {
+                opts.output = val;
+            }
+            else
+            {
+                usage(av[0]);
+                std::exit(1);
+            }
+        }
+        if (opts.decode_width == 0 || opts.num_uids == 0)
+        {
+            std::cerr << "ERROR: decode width and uids must be non-zero" << std::endl;
+            std::exit(1);
+        }
+        // A group is at least 2 UIDs, the group lengths are drawn from
+        // [2, max group size]
+        if (opts.max_group_size < 2)
+        {
+            std::cerr << "ERROR: max group size must be at least 2" << std::endl;
+            std::exit(1);
+        }
+        if (opts.fusion_density < 0.0 || opts.fusion_density > 1.0)
+        {
+            std::cerr << "ERROR: density must be between 0 and 1" << std::endl;
+            std::exit(1);
+        }
+        return opts;
+    }
+
+    //! \brief distinct groups of 2..max_group_size UIDs, saturating at limit
+    uint64_t maxDistinctGroups(const BenchOptions & opts, uint64_t limit)
+    {
+        uint64_t total = 0;
+        uint64_t per_len = opts.num_uids;
+        for (uint32_t len = 2; len <= opts.max_group_size && total < limit; ++len)
+        {
+            per_len = (per_len > limit / opts.num_uids) ? limit : per_len * opts.num_uids;
+            total = std::min(limit, total + per_len);
+        }
+        return total;
+    }
+
+    //! \brief random groups of 2..max_group_size UIDs with unique hashes
+    //!
+    //! Asking for more groups than the UID space holds would never
+    //! finish, the request is capped and the retries on a duplicate
+    //! hash are bounded. The caller reports a short set.
+    FusionGroupContainerType makeGroups(const BenchOptions & opts, uint32_t num_groups,
+                                        std::mt19937 & rng)
+    {
+        const uint64_t target = maxDistinctGroups(opts, num_groups);
+        const uint64_t max_retries = 64 * target;
+        std::uniform_int_distribution<uint32_t> uid_dist(0, opts.num_uids - 1);
+        std::uniform_int_distribution<uint32_t> len_dist(2, opts.max_group_size);
+        FusionGroupContainerType groups;
+        uint64_t retries = 0;
+        while (groups.size() < target && retries < max_retries)
+        {
+            fusion::InstUidListType uids(len_dist(rng));
+            for (auto & uid : uids)
+            {
+                uid = uid_dist(rng);
+            }
+            FusionGroupType grp("bg" + std::to_string(groups.size()), uids);
+            if (!groups.emplace(grp.hash(), grp).second)
+            {
+                ++retries;
+            }
+        }
+        return groups;
+    }
+
+    //! \brief random UIDs with group sequences seeded at fusion_density
+    //!
+    //! groups must not be empty
+    fusion::InstUidListType makeStream(const BenchOptions & opts,
+                                       FusionGroupContainerType & groups,
+                                       std::mt19937 & rng)
+    {
+        std::vector<const fusion::InstUidListType*> group_uids;
+        for (auto & fgPair : groups)
+        {
+            group_uids.push_back(&fgPair.second.uids());
+        }
+
+        std::uniform_int_distribution<uint32_t> uid_dist(0, opts.num_uids - 1);
+        std::uniform_int_distribution<size_t> grp_dist(0, group_uids.size() - 1);
+        std::bernoulli_distribution seed_group(opts.fusion_density);
+        fusion::InstUidListType stream;
+        stream.reserve(opts.num_insts + opts.max_group_size);
+        while (stream.size() < opts.num_insts)
+        {
+            if (seed_group(rng))
+            {
+                const auto & uids = *group_uids[grp_dist(rng)];
+                stream.insert(stream.end(), uids.begin(), uids.end());
+            }
+            else
+            {
+                stream.push_back(uid_dist(rng));
+            }
+        }
+        stream.resize(opts.num_insts);
+        return stream;
+    }
+
+    //! \brief run func on each decode group of the stream, returns ns/inst
+    template <typename FuncType>
+    double timeDecodeGroups(const BenchOptions & opts, const fusion::InstUidListType & stream,
+                            FuncType && func)
+    {
+        fusion::InstUidListType decode_group;
+        decode_group.reserve(opts.decode_width);
+        const auto start = Clock::now();
+        for (size_t idx = 0; idx < stream.size(); idx += opts.decode_width)
+        {
+            const size_t end = std::min<size_t>(idx + opts.decode_width, stream.size());
+            decode_group.assign(stream.begin() + idx, stream.begin() + end);
+            func(decode_group);
+        }
+        const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        return elapsed.count() / static_cast<double>(stream.size());
+    }
+
+    void writeResults(std::ostream & os, const BenchOptions & opts,
+                      const std::vector<BenchResult> & results)
+    {
+        os << "{\n"
+           << "  \"benchmark\": \"fusion_match\",\n"
+           << "  \"insts\": " << opts.num_insts << ",\n"
+           << "  \"decode_width\": " << opts.decode_width << ",\n"
+           << "  \"max_group_size\": " << opts.max_group_size << ",\n"
+           << "  \"uids\": " << opts.num_uids << ",\n"
+           << "  \"density\": " << opts.fusion_density << ",\n"
+           << "  \"seed\": " << opts.seed << ",\n"
+           << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto & r = results[i];
+            os << "    {\"matcher\": \"" << r.matcher << "\", \"groups\": " << r.num_groups
+               << ", \"ns_per_inst\": " << r.ns_per_inst << ", \"hits\": " << r.hits << "}"
+               << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        os << "  ]\n}\n";
+    }
+} // namespace
+
+//  ------------------------------------------------------------------------
+int main(int ac, char** av)
+{
+    const BenchOptions opts = parseOptions(ac, av);
+    std::vector<BenchResult> results;
+
+    for (const uint32_t requested_groups : opts.group_counts)
+    {
+        std::mt19937 rng(opts.seed);
+        FusionGroupContainerType groups = makeGroups(opts, requested_groups, rng);
+        const uint32_t num_groups = groups.size();
+        if (num_groups == 0)
+        {
+            // Nothing to seed the stream with or to match
+            std::cerr << "WARNING: no groups generated for " << requested_groups
+                      << " groups requested, skipped" << std::endl;
+            continue;
+        }
+        if (num_groups < requested_groups)
+        {
+            std::cerr << "WARNING: " << requested_groups << " groups requested, "
+                      << num_groups << " distinct groups generated" << std::endl;
+        }
+        const fusion::InstUidListType stream = makeStream(opts, groups, rng);
+
+        std::set<size_t> group_sizes;
+        RadixTrie<4> trie;
+        for (auto & fgPair : groups)
+        {
+            group_sizes.insert(fgPair.second.uids().size());
+            trie.insert(fgPair.first);
+        }
+
+        // The Decode matcher
+        fusion::HCache hcache(FusionGroupType::jenkins_1aat);
+        fusion::FusionGroupMatchInfoListType matches;
+        uint64_t hits = 0;
+        double ns = timeDecodeGroups(opts, stream,
+                                     [&](const fusion::InstUidListType & uids)
+                                     {
+                                         fusion::matchGroups(matches, uids, groups, hcache);
+                                         hits += matches.size();
+                                     });
+        results.push_back({"matchGroups", num_groups, ns, hits});
+
+        // Segment hashing alone, one cache line per distinct group size
+        hits = 0;
+        ns = timeDecodeGroups(opts, stream,
+                              [&](const fusion::InstUidListType & uids)
+                              {
+                                  hcache.clear();
+                                  for (const size_t grp_size : group_sizes)
+                                  {
+                                      if (grp_size <= uids.size())
+                                      {
+                                          hcache.buildHashCacheEntry(uids, grp_size);
+                                      }
+                                  }
+                                  hits += hcache.size();
+                              });
+        results.push_back({"hcache", num_groups, ns, hits});
+
+        // Trie membership of the segment hashes, no UID verification
+        hits = 0;
+        fusion::InstUidListType segment;
+        ns = timeDecodeGroups(opts, stream,
+                              [&](const fusion::InstUidListType & uids)
+                              {
+                                  for (const size_t grp_size : group_sizes)
+                                  {
+                                      for (size_t i = 0; i + grp_size <= uids.size(); ++i)
+                                      {
+                                          segment.assign(uids.begin() + i,
+                                                         uids.begin() + i + grp_size);
+                                          hits += trie.search(
+                                              FusionGroupType::jenkins_1aat(segment));
+                                      }
+                                  }
+                              });
+        results.push_back({"radixtrie", num_groups, ns, hits});
+    }
+
+    if (opts.output.empty())
+    {
+        writeResults(std::cout, opts, results);
+    }
+    else
+    {
+        std::ofstream out(opts.output);
+        if (!out.is_open())
+        {
+            std::cerr << "ERROR: could not open " << opts.output << std::endl;
+            return 1;
+        }
+        writeResults(out, opts, results);
+    }
+    return 0;
+}
@@ -173,15 +173,31 @@ class FusionGroupBase
 
         for (auto i : v)
         {
-            hash += i;
-            hash += (hash << 10);
-            hash ^= (hash >> 6);
+            hash = jenkins_1aat_step(hash, i);
         }
 
+        return jenkins_1aat_final(hash);
+    }
+
+    //! \brief add one uid to a partial jenkins_1aat hash
+    //!
+    //! The partial hash of a sequence extends to any longer sequence
+    //! with the same prefix, jenkins_1aat_final gives the hash of
+    //! each prefix without rehashing it.
+    static HashType jenkins_1aat_step(HashType hash, const UidType uid)
+    {
+        hash += uid;
+        hash += (hash << 10);
+        hash ^= (hash >> 6);
+        return hash;
+    }
+
+    //! \brief final mixing of a partial jenkins_1aat hash
+    static HashType jenkins_1aat_final(HashType hash)
+    {
         hash += (hash << 3);
         hash ^= (hash >> 11);
         hash += (hash << 15);
-
         return hash;
     }
 
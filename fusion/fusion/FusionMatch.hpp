@@ -0,0 +1,104 @@
+// HEADER PLACEHOLDER
+// contact Jeff Nye, jeffnye-gh
+//
+//! \file FusionMatch.hpp  fusion group matching of decoded UIDs
+#pragma once
+#include "fusion/FusionContext.hpp"
+#include "fusion/FusionTypes.hpp"
+#include "fusion/HCache.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace fusion
+{
+//! \brief the return type for group matches
+using FusionGroupMatchInfoListType = std::vector<FusionGroupMatchInfo>;
+
+// ----------------------------------------------------------------------
+//! \brief order matches, size descending then startIdx ascending
+//!
+//! Larger groups are preferred, ties go to the oldest instruction
+// ----------------------------------------------------------------------
+inline void sortMatches(FusionGroupMatchInfoListType & matches)
+{
+    std::sort(matches.begin(), matches.end(),
+              [](const FusionGroupMatchInfo & lhs, const FusionGroupMatchInfo & rhs)
+              {
+                  if (lhs.size() == rhs.size())
+                  {
+                      return lhs.startIdx < rhs.startIdx;
+                  }
+                  return lhs.size() > rhs.size();
+              });
+}
+
+// ----------------------------------------------------------------------
+//! \brief match the input UIDs against a hash keyed group container
+//!
+//! This is the Decode matcher. FusionGroups must exactly match a
+//! segment of the input.
+//!
+//! Each fusion group has a pre-calculated hash of its UIDs. The input
+//! is divided into segments of each group size and each segment is
+//! hashed, the hashes are kept in hcache indexed by size. On a hash hit
+//! the UIDs are compared to reject collisions.
+//!
+//! fusion/bench measures the cost per instruction for group sets of
+//! 16 to 4096 groups.
+// ----------------------------------------------------------------------
+template <typename FusionGroupContainerType>
+void matchGroups(FusionGroupMatchInfoListType & matches, const InstUidListType & inputUids,
+                 FusionGroupContainerType & fusionGroups, HCache & hcache)
+{
+    matches.clear(); // Clear any existing matches
+
+    // The cache is a map of cachelines, indexed by size,
+    //          <size, list of <index,hash>
+    //
+    //   3   1:hash  2:hash 3:hash  ... modulo size, inputUids.size() % 3
+    hcache.clear();
+
+    for (auto & fgPair : fusionGroups)
+    {
+        // No match possible if the fg is bigger than the input
+        const size_t grpSize = fgPair.second.uids().size();
+        if (grpSize > inputUids.size())
+        {
+            continue;
+        }
+
+        // If the grpSize is not in the hash cache we need to calculate it
+        if (hcache.find(grpSize) == hcache.end())
+        {
+            hcache.buildHashCacheEntry(inputUids, grpSize);
+        }
+
+        // pairs is from the cache entries with the same size as fGrp.
+        // a pair is <index,hash>, index is the position in the input
+        const HashType grpHash = fgPair.first;
+        auto & fGrp = fgPair.second;
+        const HCache::HashPairListType & pairs = hcache[grpSize];
+
+        // For each of the pairs that have the same size as fGrp.
+        for (auto & ep : pairs)
+        {
+            // if the pair.hash matches the group's hash
+            if (ep.second == grpHash)
+            {
+                const size_t startIdx = ep.first;
+                const bool match = std::equal(fGrp.uids().begin(), fGrp.uids().end(),
+                                              inputUids.begin() + startIdx);
+                if (match)
+                {
+                    matches.emplace_back(fGrp.name(), startIdx, 0, fGrp.uids());
+                }
+            }
+        }
+    }
+
+    sortMatches(matches);
+}
+
+} // namespace fusion
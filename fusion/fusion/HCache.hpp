@@ -6,8 +6,10 @@
 //TODO: template
 #include "fusion/FusionTypes.hpp"
 
+#include <iomanip>
 #include <map>
 #include <ostream>
+#include <utility>
 #include <vector>
 
 namespace fusion
@@ -23,7 +25,7 @@ namespace fusion
 struct HCache
 {
     //! \brief 'words' in the $ 'line' are pairs, length and resulting hash
-    using HashPair = pair<size_t,fusion::HashType>;
+    using HashPair = std::pair<size_t,fusion::HashType>;
     //! \brief value type for cache
     using HashPairListType = std::vector<HashPair>;
     //! \brief type used by the 'cache' array
@@ -62,7 +64,7 @@ struct HCache
     void buildHashCacheEntry(const InstUidListType &inputUids,size_t grpSize)
     {
         //create the sub-divisions of length grpSize
-        vector<InstUidListType> fragments;
+        std::vector<InstUidListType> fragments;
         subDivideUids(fragments,inputUids,grpSize);
 
         //this will be the 'cacheline' of hcache, calculate the
@@ -72,10 +74,10 @@ struct HCache
         size_t i=0;
         for(auto & uidVec : fragments) {
             fusion::HashType hash = hashFunc(uidVec);
-            cacheLine.push_back(make_pair(i++,hash));
+            cacheLine.push_back(std::make_pair(i++,hash));
         }
 
-        hcache.insert(make_pair(grpSize,cacheLine));
+        hcache.insert(std::make_pair(grpSize,cacheLine));
     }
 
     // ------------------------------------------------------------------
@@ -119,10 +121,10 @@ struct HCache
 
             for(auto & snd : hc.second) //hashPairListType
             {
-                os<<" "<<dec<<snd.first<<":"
-                       <<"0x"<<hex<<setw(8)<<setfill('0')<<snd.second;
+                os<<" "<<std::dec<<snd.first<<":"
+                       <<"0x"<<std::hex<<std::setw(8)<<std::setfill('0')<<snd.second;
             }
-            os<<endl;
+            os<<std::endl;
         }
     }
 
@@ -0,0 +1,143 @@
+// HEADER PLACEHOLDER
+// contact Jeff Nye, jeffnye-gh
+//
+//! \file StaticFusionTable.hpp  compile time fusion group tables
+#pragma once
+#include "fusion/FusionTypes.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fusion
+{
+// ----------------------------------------------------------------------
+//! \struct StaticFusionGroup
+//
+//! \brief one fusion group entry in a build time generated table
+//!
+//! The UIDs are not stored in the entry, uidOffset indexes into
+//! the flattened UID array of the owning StaticFusionTable.
+// ----------------------------------------------------------------------
+struct StaticFusionGroup
+{
+    //! \brief group name from the fusion group definition file
+    const char* name;
+    //! \brief transform name from the fusion group definition file
+    const char* transformName;
+    //! \brief first UID of this group in the flattened UID array
+    uint32_t uidOffset;
+    //! \brief number of UIDs in this group
+    uint32_t uidCount;
+    //! \brief jenkins_1aat hash of the UIDs, matches FusionGroup::hash()
+    HashType hash;
+};
+
+// ----------------------------------------------------------------------
+//! \class StaticFusionTable
+//
+//! \brief constexpr view over the tables emitted by gen_fusion_tables.py
+//!
+//! The generator turns a fusion group JSON file into constexpr arrays.
+//! Groups are sorted by size (descending) then hash. Lookup by hash uses
+//! a two level (hash and displace) perfect hash, one probe of the
+//! displacement array and one probe of the slot array, no collisions.
+//!
+//! The table does not own the arrays, they have static storage in the
+//! generated header.
+// ----------------------------------------------------------------------
+class StaticFusionTable
+{
+  public:
+    //! \brief slot value for an unused perfect hash slot
+    static constexpr uint16_t INVALID_SLOT = 0xFFFF;
+
+    //! \brief construct from the generated arrays
+    constexpr StaticFusionTable(const StaticFusionGroup* groups, uint32_t numGroups,
+                                const UidType* uids, const uint32_t* displacements,
+                                uint32_t numBuckets, const uint16_t* slots,
+                                uint32_t numSlots, uint32_t maxGroupSize) :
+        groups_(groups),
+        numGroups_(numGroups),
+        uids_(uids),
+        displacements_(displacements),
+        numBuckets_(numBuckets),
+        slots_(slots),
+        numSlots_(numSlots),
+        maxGroupSize_(maxGroupSize)
+    {
+    }
+
+    //! \brief number of groups in the table
+    constexpr uint32_t size() const { return numGroups_; }
+
+    //! \brief longest UID sequence across all groups
+    constexpr uint32_t maxGroupSize() const { return maxGroupSize_; }
+
+    //! \brief group accessor, groups are sorted by size then hash
+    constexpr const StaticFusionGroup & operator[](uint32_t idx) const { return groups_[idx]; }
+
+    //! \brief UID accessor for a group
+    constexpr UidType uid(const StaticFusionGroup & grp, uint32_t idx) const
+    {
+        return uids_[grp.uidOffset + idx];
+    }
+
+    //! \brief the perfect hash slot for a hash value
+    //!
+    //! Must match slot() in gen_fusion_tables.py
+    constexpr uint32_t slot(HashType hash) const
+    {
+        const uint32_t disp = displacements_[hash % numBuckets_];
+        return static_cast<uint32_t>(((hash ^ disp) * 0x9E3779B1u) >> 7) % numSlots_;
+    }
+
+    //! \brief find the group with this hash, nullptr on a miss
+    //!
+    //! A perfect hash only guarantees no collisions among the keys
+    //! in the table, the caller must compare the UIDs.
+    constexpr const StaticFusionGroup* find(HashType hash) const
+    {
+        const uint16_t idx = slots_[slot(hash)];
+        if (idx == INVALID_SLOT || groups_[idx].hash != hash)
+        {
+            return nullptr;
+        }
+        return &groups_[idx];
+    }
+
+    //! \brief true if the group UIDs equal the sequence at uids[start]
+    template <class UidListType>
+    bool matches(const StaticFusionGroup & grp, const UidListType & uids, size_t start) const
+    {
+        if (start + grp.uidCount > uids.size())
+        {
+            return false;
+        }
+        for (uint32_t i = 0; i < grp.uidCount; ++i)
+        {
+            if (uids[start + i] != uid(grp, i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //! \brief the UIDs of a group as a run-time list
+    InstUidListType uidList(const StaticFusionGroup & grp) const
+    {
+        return InstUidListType(uids_ + grp.uidOffset, uids_ + grp.uidOffset + grp.uidCount);
+    }
+
+  private:
+    const StaticFusionGroup* groups_;
+    uint32_t numGroups_;
+    const UidType* uids_;
+    const uint32_t* displacements_;
+    uint32_t numBuckets_;
+    const uint16_t* slots_;
+    uint32_t numSlots_;
+    uint32_t maxGroupSize_;
+};
+
+} // namespace fusion
@@ -0,0 +1,163 @@
+#!/bin/env python3
+
+"""Generate constexpr fusion group tables from a fusion group JSON file.
+
+The output header defines a fusion::StaticFusionTable (see
+fusion/fusion/StaticFusionTable.hpp) named fusion::generated::fusion_groups.
+The table holds the group UIDs flattened into one array, a precomputed
+jenkins_1aat hash per group and a hash-and-displace perfect hash index.
+"""
+
+import argparse
+import json
+import os
+import sys
+
+MASK32 = 0xFFFFFFFF
+INVALID_SLOT = 0xFFFF
+
+
+def jenkins_1aat(uids):
+    """Must match FusionGroupBase::jenkins_1aat"""
+    h = 0
+    for u in uids:
+        h = (h + u) & MASK32
+        h = (h + (h << 10)) & MASK32
+        h ^= h >> 6
+    h = (h + (h << 3)) & MASK32
+    h ^= h >> 11
+    h = (h + (h << 15)) & MASK32
+    return h
+
+
+def slot(h, disp, num_slots):
+    """Must match StaticFusionTable::slot"""
+    return ((((h ^ disp) * 0x9E3779B1) & MASK32) >> 7) % num_slots
+
+
+def build_perfect_hash(hashes):
+    """Hash and displace: bucket keys, place the largest buckets first,
+    searching a displacement per bucket that lands all its keys in
+    free slots."""
+    num_keys = max(len(hashes), 1)
+    num_buckets = max(num_keys // 2, 1)
+    num_slots = num_keys + num_keys // 4 + 1
+    while True:
+        buckets = [[] for _ in range(num_buckets)]
+        for idx, h in enumerate(hashes):
+            buckets[h % num_buckets].append(idx)
+        displacements = [0] * num_buckets
+        slots = [INVALID_SLOT] * num_slots
+        placed = True
+        for b in sorted(range(num_buckets), key=lambda b: -len(buckets[b])):
+            if not buckets[b]:
+                break
+            for disp in range(1 << 16):
+                targets = [slot(hashes[i], disp, num_slots) for i in buckets[b]]
+                if len(set(targets)) == len(targets) and \
+                   all(slots[t] == INVALID_SLOT for t in targets):
+                    for i, t in zip(buckets[b], targets):
+                        slots[t] = i
+                    displacements[b] = disp
+                    break
+            else:
+                placed = False
+                break
+        if placed:
+            return displacements, slots
+        num_slots = num_slots * 2
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('-i', '--input', required=True, help="fusion group JSON file")
+    parser.add_argument('-o', '--output', required=True, help="generated C++ header")
+    args = parser.parse_args()
+
+    with open(args.input) as f:
+        jgroups = json.load(f)['fusiongroups']
+
+    groups = []
+    for item in jgroups:
+        for field in ('name', 'uids', 'tx'):
+            if field not in item:
+                sys.exit(f"ERROR: {args.input}: missing field {field}")
+        uids = [int(u, 16) for u in item['uids']]
+        groups.append((item['name'], item['tx'], uids, jenkins_1aat(uids)))
+
+    # Same key as the run-time container, a duplicate hash would
+    # silently drop a group there, be loud about it here
+    seen = {}
+    for name, _, _, h in groups:
+        if h in seen:
+            sys.exit(f"ERROR: {args.input}: groups {seen[h]} and {name} share hash 0x{h:08x}")
+        seen[h] = name
+
+    groups.sort(key=lambda g: (-len(g[2]), g[3]))
+    if len(groups) >= INVALID_SLOT:
+        sys.exit(f"ERROR: {args.input}: too many fusion groups ({len(groups)})")
+
+    displacements, slots = build_perfect_hash([g[3] for g in groups])
+
+    uid_offsets = []
+    flat_uids = []
+    for g in groups:
+        uid_offsets.append(len(flat_uids))
+        flat_uids.extend(g[2])
+    max_group_size = max((len(g[2]) for g in groups), default=0)
+
+    def array_body(values, fmt, per_line):
+        lines = []
+        for i in range(0, len(values), per_line):
+            lines.append('    ' + ', '.join(fmt.format(v) for v in values[i:i + per_line]) + ',')
+        return '\n'.join(lines) if lines else '    0'
+
+    group_lines = '\n'.join(
+        f'    {{"{name}", "{tx}", {off}, {len(uids)}, 0x{h:08x}}},'
+        for (name, tx, uids, h), off in zip(groups, uid_offsets))
+    if not group_lines:
+        group_lines = '    {"", "", 0, 0, 0},'
+
+    with open(args.output, 'w') as out:
+        out.write(f"""// Generated by gen_fusion_tables.py from {args.input}. Do not edit.
+//! \\file FusionGroupTables.hpp  constexpr fusion group tables
+#pragma once
+#include "fusion/StaticFusionTable.hpp"
+
+namespace fusion::generated
+{{
+//! \\brief file name of the JSON the tables were generated from
+constexpr const char SOURCE_JSON[] = "{os.path.basename(args.input)}";
+constexpr uint32_t NUM_GROUPS = {len(groups)};
+constexpr uint32_t MAX_GROUP_SIZE = {max_group_size};
+constexpr uint32_t NUM_BUCKETS = {len(displacements)};
+constexpr uint32_t NUM_SLOTS = {len(slots)};
+
+//! \\brief group UIDs, flattened in group order
+constexpr UidType group_uids[] = {{
+{array_body(flat_uids, '0x{:x}', 12)}
+}};
+
+//! \\brief groups sorted by size (descending) then hash
+constexpr StaticFusionGroup groups[] = {{
+{group_lines}
+}};
+
+//! \\brief perfect hash first level, indexed by hash % NUM_BUCKETS
+constexpr uint32_t displacements[] = {{
+{array_body(displacements, '{}', 12)}
+}};
+
+//! \\brief perfect hash second level, group index or INVALID_SLOT
+constexpr uint16_t slots[] = {{
+{array_body(slots, '0x{:x}', 12)}
+}};
+
+constexpr StaticFusionTable fusion_groups(groups, NUM_GROUPS, group_uids, displacements,
+                                          NUM_BUCKETS, slots, NUM_SLOTS, MAX_GROUP_SIZE);
+}} // namespace fusion::generated
+""")
+
+
+if __name__ == '__main__':
+    main()
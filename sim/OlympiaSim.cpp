@@ -9,6 +9,7 @@
 #include "sparta/utils/StringUtils.hpp"
 
 #include "CPUFactory.hpp"
+#include "CoreUtils.hpp"
 #include "SimulationConfiguration.hpp"
 
 #include "OlympiaAllocators.hpp"
@@ -99,6 +100,36 @@ void OlympiaSim::configureTree_()
     if(instruction_limit_ != 0){
         max_instrs->setValueFromString(sparta::utils::uint64_to_str(instruction_limit_));
     }
+
+    // A clustered core derives its forwarding latencies from the
+    // clusters, merged into the scoreboard latency matrices: a higher
+    // latency set in a matrix is kept
+    for(uint32_t core_num = 0; core_num < num_cores_; ++core_num)
+    {
+        const std::string core_path = "cpu.core" + std::to_string(core_num);
+        const auto cluster_matrix =
+            olympia::coreutils::getClusterLatencyMatrix(getRoot()->getChild(core_path));
+        if(cluster_matrix.empty()) {
+            continue;
+        }
+        for(uint32_t rf = 0; rf < olympia::core_types::N_REGFILES; ++rf)
+        {
+            auto latency_param =
+                getRoot()->getChildAs<sparta::Parameter<olympia::CoreExtensions::ClusterTopology>>(
+                    core_path + ".rename.scoreboards." + olympia::core_types::regfile_names[rf]
+                    + ".params.latency_matrix");
+            const auto & latency_matrix = latency_param->getValue();
+            uint32_t num_raised = 0;
+            const auto merged = olympia::coreutils::mergeClusterLatencyMatrix(
+                latency_matrix, cluster_matrix, num_raised);
+            if(num_raised != 0 && !olympia::coreutils::isUniformLatencyMatrix(latency_matrix)) {
+                std::cerr << "WARNING: " << latency_param->getLocation() << ": "
+                          << num_raised << " latencies below the cluster latencies are replaced"
+                          << std::endl;
+            }
+            latency_param->setValue(merged);
+        }
+    }
 }
 
 void OlympiaSim::bindTree_()
@@ -0,0 +1,81 @@
+#include "CriticalityPredictor.hpp"
+#include "sparta/utils/SpartaTester.hpp"
+
+TEST_INIT
+
+// 8 entries, critical at 2, counters saturate at 3
+void testSaturation()
+{
+    olympia::CriticalityPredictor predictor(8, 2, 3);
+    EXPECT_TRUE(predictor.isEnabled());
+
+    const uint64_t pc_a = 0x100; // entry 0
+    const uint64_t pc_b = 0x102; // entry 1
+    predictor.train(pc_a);
+    EXPECT_FALSE(predictor.isCritical(pc_a));
+    predictor.train(pc_a);
+    EXPECT_TRUE(predictor.isCritical(pc_a));
+
+    // Counter stops at 3
+    predictor.train(pc_a);
+    predictor.train(pc_a);
+    predictor.train(pc_a);
+    EXPECT_TRUE(predictor.isCritical(pc_a));
+    EXPECT_FALSE(predictor.isCritical(pc_b));
+
+    // PCs 16 bytes apart share an entry
+    EXPECT_TRUE(predictor.isCritical(pc_a + 0x10));
+
+    predictor.train(pc_b);
+    predictor.train(pc_b);
+    EXPECT_TRUE(predictor.isCritical(pc_b));
+
+    // The 8th training halves every counter: 3 -> 1 for both. Without
+    // the saturation pc_a would be at 5 and stay critical
+    predictor.train(pc_b);
+    EXPECT_FALSE(predictor.isCritical(pc_a));
+    EXPECT_FALSE(predictor.isCritical(pc_b));
+}
+
+// Counters halve every table size trainings, from the last halving
+void testAging()
+{
+    olympia::CriticalityPredictor predictor(4, 2, 7);
+
+    const uint64_t pc = 0x204;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        predictor.train(pc);
+    }
+    EXPECT_TRUE(predictor.isCritical(pc));
+
+    // 4th training: 4 -> 2, still critical
+    predictor.train(pc);
+    EXPECT_TRUE(predictor.isCritical(pc));
+
+    // 4 more trainings elsewhere: 2 -> 1
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        predictor.train(pc + 2);
+    }
+    EXPECT_FALSE(predictor.isCritical(pc));
+}
+
+// A table size of 0 disables the predictor
+void testDisabled()
+{
+    olympia::CriticalityPredictor predictor(0, 1, 3);
+    EXPECT_FALSE(predictor.isEnabled());
+    predictor.train(0x100);
+    EXPECT_FALSE(predictor.isCritical(0x100));
+}
+
+int main()
+{
+    testSaturation();
+    testAging();
+    testDisabled();
+
+    REPORT_ERROR;
+    return (int)ERROR_CODE;
+}
@@ -0,0 +1,96 @@
+#include "FlushEpoch.hpp"
+#include "sparta/utils/SpartaTester.hpp"
+
+#include <vector>
+
+TEST_INIT
+
+// Instructions 1-10 fetched, flush from 6, refetch 6-8, flush from 4
+void testNestedFlushes()
+{
+    olympia::FlushEpoch epoch;
+
+    const auto first = epoch.getGeneration();
+    EXPECT_FALSE(first->isSquashed(1));
+    EXPECT_FALSE(first->isSquashed(10));
+
+    epoch.flush(6);
+    EXPECT_FALSE(first->isSquashed(5));
+    EXPECT_TRUE(first->isSquashed(6));
+    EXPECT_TRUE(first->isSquashed(10));
+
+    // Instructions fetched after the flush are not squashed by it
+    const auto second = epoch.getGeneration();
+    EXPECT_TRUE(first != second);
+    EXPECT_FALSE(second->isSquashed(6));
+    EXPECT_FALSE(second->isSquashed(8));
+
+    // An older flush lowers the boundary of every earlier generation
+    epoch.flush(4);
+    EXPECT_TRUE(first->isSquashed(4));
+    EXPECT_FALSE(first->isSquashed(3));
+    EXPECT_TRUE(second->isSquashed(6));
+    EXPECT_FALSE(second->isSquashed(3));
+
+    // A younger flush leaves the older boundaries alone
+    const auto third = epoch.getGeneration();
+    epoch.flush(5);
+    EXPECT_TRUE(first->isSquashed(4));
+    EXPECT_TRUE(second->isSquashed(4));
+    EXPECT_FALSE(third->isSquashed(4));
+    EXPECT_TRUE(third->isSquashed(5));
+    EXPECT_FALSE(epoch.getGeneration()->isSquashed(5));
+}
+
+// The epoch keeps only the generations with instructions in flight
+void testBoundedWindow()
+{
+    olympia::FlushEpoch epoch;
+    EXPECT_EQUAL(epoch.getNumGenerations(), 1u);
+
+    // An instruction of the first generation stays in flight
+    auto oldest = epoch.getGeneration();
+    for (uint64_t uid = 100; uid < 110; ++uid)
+    {
+        const auto generation = epoch.getGeneration();
+        epoch.flush(uid);
+        EXPECT_TRUE(generation->isSquashed(uid));
+    }
+    EXPECT_EQUAL(epoch.getNumGenerations(), 11u);
+    EXPECT_TRUE(oldest->isSquashed(100));
+    EXPECT_FALSE(oldest->isSquashed(99));
+
+    // Once it retires, the next flush drops the dead generations
+    oldest.reset();
+    epoch.flush(200);
+    EXPECT_EQUAL(epoch.getNumGenerations(), 1u);
+
+    // Many flushes with nothing in flight do not grow the history
+    for (uint64_t uid = 300; uid < 1300; ++uid)
+    {
+        epoch.flush(uid);
+    }
+    EXPECT_EQUAL(epoch.getNumGenerations(), 1u);
+
+    // Live generations behind a dead one are still updated
+    std::vector<olympia::FlushEpoch::GenerationPtr> in_flight;
+    in_flight.emplace_back(epoch.getGeneration());
+    epoch.flush(2000);
+    auto dead = epoch.getGeneration();
+    epoch.flush(3000);
+    dead.reset();
+    in_flight.emplace_back(epoch.getGeneration());
+    epoch.flush(1500);
+    EXPECT_TRUE(in_flight[0]->isSquashed(1500));
+    EXPECT_TRUE(in_flight[1]->isSquashed(1500));
+    EXPECT_FALSE(in_flight[0]->isSquashed(1499));
+}
+
+int main()
+{
+    testNestedFlushes();
+    testBoundedWindow();
+
+    REPORT_ERROR;
+    return (int)ERROR_CODE;
+}
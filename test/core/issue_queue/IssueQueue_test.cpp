@@ -6,6 +6,7 @@
 #include "OlympiaAllocators.hpp"
 #include "OlympiaSim.hpp"
 #include "IssueQueue.hpp"
+#include "LoadWakeup.hpp"
 #include "test/core/dispatch/Dispatch_test.hpp"
 
 #include "sparta/app/CommandLineSimulator.hpp"
@@ -20,6 +21,7 @@
 #include "sparta/utils/SpartaSharedPointer.hpp"
 #include "sparta/utils/SpartaTester.hpp"
 
+#include <algorithm>
 #include <cinttypes>
 #include <initializer_list>
 #include <memory>
@@ -51,8 +53,288 @@ public:
     // so alu0's total_insts_issued should be 1
     EXPECT_TRUE(issuequeue.total_insts_issued_ == 0);
   }
+
+  // Instructions waiting on their operands in an issue queue, in age
+  // (unique ID) order
+  std::vector<std::pair<olympia::IssueQueue *, olympia::InstPtr>>
+  waitingInsts(const std::vector<olympia::IssueQueue *> &issuequeues) {
+    std::vector<std::pair<olympia::IssueQueue *, olympia::InstPtr>> waiting;
+    for (auto issuequeue : issuequeues) {
+      for (uint32_t slot = 0; slot < issuequeue->scheduler_size_; ++slot) {
+        const uint64_t slot_bit = uint64_t(1) << slot;
+        if ((issuequeue->valid_slots_ & ~issuequeue->ready_slots_ &
+             ~issuequeue->spec_issued_slots_) & slot_bit) {
+          waiting.emplace_back(issuequeue, issuequeue->slots_[slot]);
+        }
+      }
+    }
+    std::sort(waiting.begin(), waiting.end(),
+              [](const auto &a, const auto &b) {
+                return a.second->getUniqueID() < b.second->getUniqueID();
+              });
+    return waiting;
+  }
+
+  // A load producing the sources of inst in register file rf, for the
+  // wakeups of the LSU
+  olympia::InstPtr makeProducerLoad(
+      const olympia::InstPtr &inst,
+      const olympia::core_types::RegFile rf = olympia::core_types::RegFile::RF_INTEGER) {
+    olympia::InstPtr load(new olympia::Inst(*inst));
+    olympia::Inst::RenameData::Reg dest;
+    dest.rf = rf;
+    load->getRenameData().setDestination(dest);
+    load->getDestRegisterBitMask(rf) = inst->getSrcRegisterBitMask(rf);
+    return load;
+  }
+
+  void sendWakeup(olympia::IssueQueue &issuequeue,
+                  const olympia::LoadWakeup::Type type,
+                  const olympia::InstPtr &load) {
+    issuequeue.handleLoadWakeup_({type, load});
+  }
+
+  bool isHeld(olympia::IssueQueue &issuequeue, const olympia::InstPtr &inst) {
+    for (uint32_t slot = 0; slot < issuequeue.scheduler_size_; ++slot) {
+      if (((issuequeue.spec_issued_slots_ >> slot) & 1) &&
+          (issuequeue.slots_[slot] == inst)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool isWaiting(olympia::IssueQueue &issuequeue,
+                 const olympia::InstPtr &inst) {
+    const auto waiting = waitingInsts({&issuequeue});
+    return std::any_of(waiting.begin(), waiting.end(),
+                       [&inst](const auto &entry) { return entry.second == inst; });
+  }
+
+  bool isDestReady(olympia::IssueQueue &issuequeue,
+                   const olympia::InstPtr &inst) {
+    const auto rf = olympia::core_types::RegFile::RF_INTEGER;
+    return issuequeue.scoreboard_views_[rf]->isSet(
+        inst->getDestRegisterBitMask(rf));
+  }
+
+  uint64_t specIssued(olympia::IssueQueue &issuequeue) {
+    return issuequeue.spec_insts_issued_.get();
+  }
+
+  uint64_t specReplayed(olympia::IssueQueue &issuequeue) {
+    return issuequeue.spec_insts_replayed_.get();
+  }
+
+  uint64_t operandsNotForwarded(olympia::IssueQueue &issuequeue) {
+    return issuequeue.operands_not_forwarded_.get();
+  }
+
+  uint64_t issued(olympia::IssueQueue &issuequeue) {
+    return issuequeue.total_insts_issued_.get();
+  }
+
+  bool inOrderIssue(olympia::IssueQueue &issuequeue) {
+    return issuequeue.in_order_issue_;
+  }
+
+  // Instructions the queue can issue a cycle
+  uint32_t issueWidth(olympia::IssueQueue &issuequeue) {
+    return (issuequeue.issue_width_ != 0) ? issuequeue.issue_width_
+                                          : issuequeue.pipes_.size();
+  }
 };
 
+// Three adds wait on loads that never complete (the LSU is a sink).
+// Their loads are woken speculatively: the first hits, the second
+// misses and the third is not resolved within the shadow window.
+void testLoadWakeup(sparta::app::CommandLineSimulator &cls, DispatchSim &sim) {
+  sparta::RootTreeNode *root_node = sim.getRoot();
+  std::vector<olympia::IssueQueue *> issuequeues;
+  for (uint32_t iq = 0; iq < 5; ++iq) {
+    issuequeues.emplace_back(
+        root_node->getChild("execute.iq" + std::to_string(iq))
+            ->getResourceAs<olympia::IssueQueue *>());
+  }
+  olympia::IssueQueueTester tester;
+
+  cls.runSimulator(&sim, 10);
+  const auto waiting = tester.waitingInsts(issuequeues);
+  EXPECT_EQUAL(waiting.size(), 3u);
+  if (waiting.size() != 3) {
+    return;
+  }
+
+  // Hit: the dependent issues in the shadow of the wakeup and is held,
+  // its result is published once the load hits
+  {
+    auto &[issuequeue, inst] = waiting[0];
+    const auto load = tester.makeProducerLoad(inst);
+    const uint64_t issued = tester.specIssued(*issuequeue);
+    tester.sendWakeup(*issuequeue, olympia::LoadWakeup::Type::WAKEUP, load);
+    cls.runSimulator(&sim, 2);
+    EXPECT_EQUAL(tester.specIssued(*issuequeue), issued + 1);
+    EXPECT_TRUE(tester.isHeld(*issuequeue, inst));
+    EXPECT_FALSE(tester.isDestReady(*issuequeue, inst));
+
+    tester.sendWakeup(*issuequeue, olympia::LoadWakeup::Type::HIT, load);
+    EXPECT_FALSE(tester.isHeld(*issuequeue, inst));
+    cls.runSimulator(&sim, 3);
+    EXPECT_TRUE(tester.isDestReady(*issuequeue, inst));
+  }
+
+  // Miss: the dependent is replayed and waits on the scoreboard again,
+  // its result was never published
+  {
+    auto &[issuequeue, inst] = waiting[1];
+    const auto load = tester.makeProducerLoad(inst);
+    const uint64_t replayed = tester.specReplayed(*issuequeue);
+    tester.sendWakeup(*issuequeue, olympia::LoadWakeup::Type::WAKEUP, load);
+    cls.runSimulator(&sim, 2);
+    EXPECT_TRUE(tester.isHeld(*issuequeue, inst));
+
+    tester.sendWakeup(*issuequeue, olympia::LoadWakeup::Type::MISS, load);
+    EXPECT_EQUAL(tester.specReplayed(*issuequeue), replayed + 1);
+    EXPECT_TRUE(tester.isWaiting(*issuequeue, inst));
+    cls.runSimulator(&sim, 3);
+    EXPECT_TRUE(tester.isWaiting(*issuequeue, inst));
+    EXPECT_FALSE(tester.isDestReady(*issuequeue, inst));
+  }
+
+  // Shadow expiry: no hit or miss within load_shadow_window, the
+  // dependent is replayed
+  {
+    auto &[issuequeue, inst] = waiting[2];
+    const auto load = tester.makeProducerLoad(inst);
+    const uint64_t replayed = tester.specReplayed(*issuequeue);
+    tester.sendWakeup(*issuequeue, olympia::LoadWakeup::Type::WAKEUP, load);
+    cls.runSimulator(&sim, 2);
+    EXPECT_TRUE(tester.isHeld(*issuequeue, inst));
+    cls.runSimulator(&sim, 8);
+    EXPECT_EQUAL(tester.specReplayed(*issuequeue), replayed + 1);
+    EXPECT_TRUE(tester.isWaiting(*issuequeue, inst));
+    EXPECT_FALSE(tester.isDestReady(*issuequeue, inst));
+
+    // A late hit of an expired load is ignored
+    tester.sendWakeup(*issuequeue, olympia::LoadWakeup::Type::HIT, load);
+    EXPECT_TRUE(tester.isWaiting(*issuequeue, inst));
+  }
+}
+
+// Three muls in iq1 wait on loads that never complete (the LSU is a
+// sink). The loads are woken youngest first, so the muls become ready
+// in the reverse of their age. They issue issue_width a cycle: oldest
+// first with age ordering, first ready first with in_order_issue.
+void testIssueOrder(sparta::app::CommandLineSimulator &cls, DispatchSim &sim) {
+  sparta::RootTreeNode *root_node = sim.getRoot();
+  olympia::IssueQueue *issuequeue =
+      root_node->getChild("execute.iq1")->getResourceAs<olympia::IssueQueue *>();
+  olympia::IssueQueueTester tester;
+
+  cls.runSimulator(&sim, 10);
+  const auto waiting = tester.waitingInsts({issuequeue});
+  EXPECT_EQUAL(waiting.size(), 3u);
+  if (waiting.size() != 3) {
+    return;
+  }
+
+  std::vector<olympia::InstPtr> expected;
+  for (auto entry = waiting.rbegin(); entry != waiting.rend(); ++entry) {
+    tester.sendWakeup(*issuequeue, olympia::LoadWakeup::Type::WAKEUP,
+                      tester.makeProducerLoad(entry->second));
+    expected.emplace_back(entry->second);
+  }
+  if (!tester.inOrderIssue(*issuequeue)) {
+    std::reverse(expected.begin(), expected.end());
+  }
+
+  // Issued instructions, in issue_width groups per cycle
+  const uint32_t issue_width = tester.issueWidth(*issuequeue);
+  std::vector<std::vector<olympia::InstPtr>> issued;
+  std::vector<olympia::InstPtr> all_issued;
+  for (uint32_t cycle = 0; (cycle < 10) && (all_issued.size() < waiting.size()); ++cycle) {
+    cls.runSimulator(&sim, 1);
+    std::vector<olympia::InstPtr> issued_now;
+    for (const auto &entry : waiting) {
+      if (tester.isHeld(*issuequeue, entry.second) &&
+          (std::find(all_issued.begin(), all_issued.end(), entry.second) ==
+           all_issued.end())) {
+        issued_now.emplace_back(entry.second);
+        all_issued.emplace_back(entry.second);
+      }
+    }
+    if (!issued_now.empty()) {
+      issued.emplace_back(issued_now);
+    }
+  }
+
+  std::vector<std::vector<olympia::InstPtr>> expected_groups;
+  for (uint32_t idx = 0; idx < expected.size(); idx += issue_width) {
+    std::vector<olympia::InstPtr> group(
+        expected.begin() + idx,
+        expected.begin() + std::min<size_t>(idx + issue_width, expected.size()));
+    std::sort(group.begin(), group.end(), [](const auto &a, const auto &b) {
+      return a->getUniqueID() < b->getUniqueID();
+    });
+    expected_groups.emplace_back(group);
+  }
+  EXPECT_EQUAL(issued.size(), expected_groups.size());
+  EXPECT_TRUE(issued == expected_groups);
+}
+
+// A vadd.vx waits on an integer load and a vector load that never
+// complete (the LSU is a sink). It becomes ready only once the
+// sources in both register files are, whichever file is first.
+void testMixedWakeup(sparta::app::CommandLineSimulator &cls, DispatchSim &sim) {
+  sparta::RootTreeNode *root_node = sim.getRoot();
+  olympia::IssueQueue *issuequeue =
+      root_node->getChild("execute.iq5")->getResourceAs<olympia::IssueQueue *>();
+  olympia::IssueQueueTester tester;
+
+  cls.runSimulator(&sim, 10);
+  const auto waiting = tester.waitingInsts({issuequeue});
+  EXPECT_EQUAL(waiting.size(), 1u);
+  if (waiting.size() != 1) {
+    return;
+  }
+  const auto &inst = waiting[0].second;
+  const uint64_t issued = tester.specIssued(*issuequeue);
+
+  // The integer source alone does not wake it
+  tester.sendWakeup(*issuequeue, olympia::LoadWakeup::Type::WAKEUP,
+                    tester.makeProducerLoad(inst));
+  cls.runSimulator(&sim, 2);
+  EXPECT_TRUE(tester.isWaiting(*issuequeue, inst));
+  EXPECT_EQUAL(tester.specIssued(*issuequeue), issued);
+
+  // With the vector source it issues
+  tester.sendWakeup(*issuequeue, olympia::LoadWakeup::Type::WAKEUP,
+                    tester.makeProducerLoad(inst, olympia::core_types::RegFile::RF_VECTOR));
+  cls.runSimulator(&sim, 2);
+  EXPECT_FALSE(tester.isWaiting(*issuequeue, inst));
+  EXPECT_TRUE(tester.isHeld(*issuequeue, inst));
+  EXPECT_EQUAL(tester.specIssued(*issuequeue), issued + 1);
+}
+
+// A div in iq0 produces the source of a mul in iq1 and an fcvt.s.w in
+// iq2. The divide pipe forwards to the multiply pipe, the mul issues
+// as soon as it is woken. The i2f pipe has no path and is held until
+// the result reaches the register file.
+void testPartialBypass(sparta::app::CommandLineSimulator &cls, DispatchSim &sim) {
+  sparta::RootTreeNode *root_node = sim.getRoot();
+  olympia::IssueQueue *forwarded =
+      root_node->getChild("execute.iq1")->getResourceAs<olympia::IssueQueue *>();
+  olympia::IssueQueue *not_forwarded =
+      root_node->getChild("execute.iq2")->getResourceAs<olympia::IssueQueue *>();
+  olympia::IssueQueueTester tester;
+
+  cls.runSimulator(&sim, 60);
+  EXPECT_EQUAL(tester.issued(*forwarded), 1u);
+  EXPECT_EQUAL(tester.issued(*not_forwarded), 1u);
+  EXPECT_EQUAL(tester.operandsNotForwarded(*forwarded), 0u);
+  EXPECT_TRUE(tester.operandsNotForwarded(*not_forwarded) > 0);
+}
+
 void runIQTest(int argc, char **argv) {
   DEFAULTS.auto_summary_default = "off";
   std::vector<std::string> datafiles;
@@ -129,6 +411,26 @@ void runIQTest(int argc, char **argv) {
     issuequeue_tester.test_occupied(*my_issuequeue1);
     issuequeue_tester.test_empty(*my_issuequeue);
     issuequeue_tester.test_empty(*my_issuequeue2);
+  } else if (input_file.find("test_load_wakeup.json") != std::string::npos) {
+    DispatchSim sim(&sched, "mavis_isa_files", "arch/isa_json", datafiles[0],
+                    input_file, enable_vector);
+    cls.populateSimulation(&sim);
+    testLoadWakeup(cls, sim);
+  } else if (input_file.find("test_issue_order.json") != std::string::npos) {
+    DispatchSim sim(&sched, "mavis_isa_files", "arch/isa_json", datafiles[0],
+                    input_file, enable_vector);
+    cls.populateSimulation(&sim);
+    testIssueOrder(cls, sim);
+  } else if (input_file.find("test_mixed_wakeup.json") != std::string::npos) {
+    DispatchSim sim(&sched, "mavis_isa_files", "arch/isa_json", datafiles[0],
+                    input_file, enable_vector);
+    cls.populateSimulation(&sim);
+    testMixedWakeup(cls, sim);
+  } else if (input_file.find("test_partial_bypass.json") != std::string::npos) {
+    DispatchSim sim(&sched, "mavis_isa_files", "arch/isa_json", datafiles[0],
+                    input_file, enable_vector);
+    cls.populateSimulation(&sim);
+    testPartialBypass(cls, sim);
   } else if (input_file.find("test_two_int_pipe.json") != std::string::npos) {
     uint64_t ilimit = 0;
     uint32_t num_cores = 1;
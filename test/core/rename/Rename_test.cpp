@@ -2,6 +2,7 @@
 #include "CoreUtils.hpp"
 #include "Dispatch.hpp"
 #include "ExecutePipe.hpp"
+#include "Fetch.hpp"
 #include "LSU.hpp"
 #include "MavisUnit.hpp"
 #include "OlympiaAllocators.hpp"
@@ -37,43 +38,51 @@ TEST_INIT
 olympia::InstAllocator inst_allocator(2000, 1000);
 
 class olympia::RenameTester {
+  static uint32_t count_free_bits(const olympia::RegisterFreeList &freelist) {
+    uint32_t num_free = 0;
+    for (uint32_t prf = 0; prf < freelist.capacity(); ++prf) {
+      num_free += freelist.isFree(prf) ? 1 : 0;
+    }
+    return num_free;
+  }
+
 public:
   void test_clearing_rename_structures(olympia::Rename &rename) {
     // after all instructions have retired, we should have:
     // num_rename_registers - 31 registers = freelist size
     // because we initialize the first 31 registers (x1-x31) for integer
-    if (rename.reference_counter_[0].size() == 34) {
+    if (rename.freelist_[0].capacity() == 34) {
       EXPECT_TRUE(rename.freelist_[0].size() == 3);
-      // in the case of only two free PRFs, they should NOT be equal to each
-      // other
-      EXPECT_TRUE(rename.freelist_[0].front() != rename.freelist_[0].back());
+      // the free PRFs should be distinct, the free bitmap agrees with
+      // the free count
+      EXPECT_TRUE(count_free_bits(rename.freelist_[0]) == 3);
     } else {
       EXPECT_TRUE(rename.freelist_[0].size() == 97);
     }
     // we're only expecting one reference
-    EXPECT_TRUE(rename.reference_counter_[0][1] == 1);
-    EXPECT_TRUE(rename.reference_counter_[0][2] == 1);
+    EXPECT_TRUE(rename.freelist_[0].refCount(1) == 1);
+    EXPECT_TRUE(rename.freelist_[0].refCount(2) == 1);
   }
   void test_clearing_rename_structures_amoadd(olympia::Rename &rename) {
     // after all instructions have retired, we should have:
     // num_rename_registers - 32 registers = freelist size
     // because we initialize the first 32 registers
-    if (rename.reference_counter_[0].size() == 34) {
+    if (rename.freelist_[0].capacity() == 34) {
       EXPECT_TRUE(rename.freelist_[0].size() == 3);
-      // in the case of only two free PRFs, they should NOT be equal to each
-      // other
-      EXPECT_TRUE(rename.freelist_[0].front() != rename.freelist_[0].back());
+      // the free PRFs should be distinct, the free bitmap agrees with
+      // the free count
+      EXPECT_TRUE(count_free_bits(rename.freelist_[0]) == 3);
     } else {
       EXPECT_TRUE(rename.freelist_[0].size() == 96);
     }
     // we're only expecting one reference
-    EXPECT_TRUE(rename.reference_counter_[0][1] == 1);
-    EXPECT_TRUE(rename.reference_counter_[0][2] == 0);
+    EXPECT_TRUE(rename.freelist_[0].refCount(1) == 1);
+    EXPECT_TRUE(rename.freelist_[0].refCount(2) == 0);
   }
   void test_one_instruction(olympia::Rename &rename) {
     // process only one instruction, check that freelist and map_tables are
     // allocated correctly
-    if (rename.reference_counter_[0].size() == 34) {
+    if (rename.freelist_[0].capacity() == 34) {
       EXPECT_TRUE(rename.freelist_[0].size() == 2);
     } else {
       EXPECT_TRUE(rename.freelist_[0].size() == 96);
@@ -82,35 +91,35 @@ public:
 
     // reference counters should now be 2 because the first instruction is:
     // ADD x3 x1 x2 and both x1 -> prf1 and x2 -> prf2
-    EXPECT_TRUE(rename.reference_counter_[0][1] == 2);
-    EXPECT_TRUE(rename.reference_counter_[0][2] == 2);
+    EXPECT_TRUE(rename.freelist_[0].refCount(1) == 2);
+    EXPECT_TRUE(rename.freelist_[0].refCount(2) == 2);
   }
   void test_multiple_instructions(olympia::Rename &rename) {
     // first two instructions are RAW
     // so the second instruction should increase reference count
-    EXPECT_TRUE(rename.reference_counter_[0][2] == 3);
+    EXPECT_TRUE(rename.freelist_[0].refCount(2) == 3);
   }
   void test_startup_rename_structures(olympia::Rename &rename) {
     // before starting, we should have:
     // num_rename_registers - 32 registers = freelist size
     // because we initialize the first 32 registers
-    if (rename.reference_counter_[0].size() == 34) {
+    if (rename.freelist_[0].capacity() == 34) {
       EXPECT_TRUE(rename.freelist_[0].size() == 3);
     } else {
       EXPECT_TRUE(rename.freelist_[0].size() == 97);
     }
     // we're only expecting a value of 1 for registers x0 -> x31 because we
     // initialize them
-    EXPECT_TRUE(rename.reference_counter_[0][1] == 1);
-    EXPECT_TRUE(rename.reference_counter_[0][2] == 1);
-    EXPECT_TRUE(rename.reference_counter_[0][30] == 1);
-    EXPECT_TRUE(rename.reference_counter_[0][31] == 1);
+    EXPECT_TRUE(rename.freelist_[0].refCount(1) == 1);
+    EXPECT_TRUE(rename.freelist_[0].refCount(2) == 1);
+    EXPECT_TRUE(rename.freelist_[0].refCount(30) == 1);
+    EXPECT_TRUE(rename.freelist_[0].refCount(31) == 1);
     // x0 for RF_INTEGER should be not assigned because x0 for RF_INTEGER doesn't use physical registerfile
     // since it's hardcoded to 0, no need to rename, so we get an extra free register back. Test to make sure
     // this is actually modeled
-    EXPECT_TRUE(rename.reference_counter_[0][0] == 0);
-    EXPECT_TRUE(rename.reference_counter_[0][32] == 0);
-    EXPECT_TRUE(rename.reference_counter_[0][33] == 0);
+    EXPECT_TRUE(rename.freelist_[0].refCount(0) == 0);
+    EXPECT_TRUE(rename.freelist_[0].refCount(32) == 0);
+    EXPECT_TRUE(rename.freelist_[0].refCount(33) == 0);
   }
   void test_float(olympia::Rename &rename) {
     // ensure the correct register file is used
@@ -119,6 +128,37 @@ public:
   }
 };
 
+class olympia::FetchTester {
+public:
+  void test_icount_selection(olympia::Fetch &fetch) {
+    // ICOUNT fetches the thread with the fewest instructions fetched
+    // and not yet retired, the lowest thread on a tie
+    EXPECT_EQUAL(fetch.num_threads_, 2u);
+    const auto saved = fetch.in_flight_insts_;
+    EXPECT_FALSE(saved[0].empty() && saved[1].empty());
+    if (saved[0].empty() && saved[1].empty()) {
+      return;
+    }
+    // Only the number of instructions in flight matters
+    const auto inst = saved[0].empty() ? saved[1].front() : saved[0].front();
+    auto &in_flight = fetch.in_flight_insts_;
+    in_flight[0].assign(3, inst);
+    in_flight[1].assign(1, inst);
+    EXPECT_EQUAL(fetch.selectThread_(), 1u);
+    in_flight[1].assign(4, inst);
+    EXPECT_EQUAL(fetch.selectThread_(), 0u);
+    in_flight[0].assign(4, inst);
+    EXPECT_EQUAL(fetch.selectThread_(), 0u);
+    fetch.in_flight_insts_ = saved;
+  }
+  void test_all_fetched(olympia::Fetch &fetch, const uint64_t num_insts) {
+    // Both threads fetched their whole workload
+    for (uint32_t thread_id = 0; thread_id < fetch.num_threads_; ++thread_id) {
+      EXPECT_EQUAL(fetch.thread_fetched_insts_[thread_id]->get(), num_insts);
+    }
+  }
+};
+
 class olympia::IssueQueueTester {
 public:
   void
@@ -483,6 +523,17 @@ void runTest(int argc, char **argv) {
     olympia::RenameTester rename_tester;
     cls.runSimulator(&sim);
     rename_tester.test_clearing_rename_structures_amoadd(*my_rename);
+  } else if (input_file.find("smt_icount.json") != std::string::npos) {
+    // Two hardware threads running the same workload
+    cls.populateSimulation(&sim);
+    sparta::RootTreeNode *root_node = sim.getRoot();
+    olympia::Fetch *my_fetch = root_node->getChild("cpu.core0.fetch")
+                                   ->getResourceAs<olympia::Fetch *>();
+    olympia::FetchTester fetch_tester;
+    cls.runSimulator(&sim, 4);
+    fetch_tester.test_icount_selection(*my_fetch);
+    cls.runSimulator(&sim);
+    fetch_tester.test_all_fetched(*my_fetch, 32);
   } else if (input_file.find("rename_multiple_instructions_full.json") !=
              std::string::npos) {
     sparta::RootTreeNode *root_node = sim.getRoot();